@@ -12,34 +12,111 @@
 DECLARE_GLOBAL_DATA_PTR;
 
 #ifndef CONFIG_SYS_DCACHE_OFF
-void set_pgtable_section(u64 *page_table, u64 index, u64 section,
-			 u64 memory_type)
+/*
+ * regions mapped other than their bank, applied by every mmu_setup().
+ * In .data as the cache range functions may run before relocation.
+ */
+#define MMU_MAX_REGIONS		8
+
+static struct mmu_region {
+	phys_addr_t	start;
+	phys_addr_t	end;
+	u64		memory_type;
+} mmu_regions[MMU_MAX_REGIONS] __attribute__ ((section(".data")));
+static int mmu_nr_regions __attribute__ ((section(".data")));
+static int mmu_l3_tables __attribute__ ((section(".data")));
+
+static u64 mmu_desc(u64 addr, u64 memory_type)
 {
 	u64 value;
 
-	value = section | PMD_TYPE_SECT | PMD_SECT_AF;
+	value = addr | PMD_SECT_AF;
 #ifdef CONFIG_CMD_AML_MTEST
 	if (memory_type == MT_NORMAL)
 		value |= PMD_SECT_S;
 #endif
 	value |= PMD_ATTRINDX(memory_type);
-	page_table[index] = value;
+	return value;
+}
+
+void set_pgtable_section(u64 *page_table, u64 index, u64 section,
+			 u64 memory_type)
+{
+	page_table[index] = mmu_desc(section, memory_type) | PMD_TYPE_SECT;
+}
+
+/*
+ * Level 3 table of section @index, from the space after the level 2
+ * table. A new one maps its pages as the section did.
+ */
+static u64 *mmu_l3_table(u64 *page_table, u64 index)
+{
+	u64 desc = page_table[index];
+	u64 base = index << SECTION_SHIFT;
+	u64 memory_type, *table, i;
+
+	if ((desc & PMD_TYPE_MASK) == PMD_TYPE_TABLE)
+		return (u64 *)(desc & PAGE_MASK);
+	if (mmu_l3_tables == CONFIG_SYS_MMU_L3_TABLES)
+		return NULL;
+
+	table = (u64 *)(gd->arch.tlb_addr +
+			((u64)++mmu_l3_tables << PAGE_SHIFT));
+	memory_type = (desc & PMD_ATTRINDX_MASK) >> 2;
+	for (i = 0; i < PTE_TABLE_ENTRIES; i++)
+		table[i] = mmu_desc(base + (i << PAGE_SHIFT), memory_type) |
+			PTE_TYPE_PAGE;
+	page_table[index] = (u64)table | PMD_TYPE_TABLE;
+	return table;
+}
+
+/* map [start, end) as @memory_type, whole sections where possible */
+static void mmu_map_range(u64 *page_table, u64 start, u64 end,
+			  u64 memory_type)
+{
+	u64 next, index, i, *table;
+
+	start &= PAGE_MASK;
+	end = ALIGN(end, PAGE_SIZE);
+	for (; start < end; start = next) {
+		index = start >> SECTION_SHIFT;
+		next = (index + 1) << SECTION_SHIFT;
+		if (!(start & ~SECTION_MASK) && next <= end &&
+		    (page_table[index] & PMD_TYPE_MASK) != PMD_TYPE_TABLE) {
+			set_pgtable_section(page_table, index, start,
+					    memory_type);
+			continue;
+		}
+
+		table = mmu_l3_table(page_table, index);
+		if (!table) {
+			printf("mmu: no level 3 table for 0x%llx, raise "
+			       "CONFIG_SYS_MMU_L3_TABLES\n", start);
+			return;
+		}
+		if (next > end)
+			next = end;
+		for (i = start; i < next; i += PAGE_SIZE)
+			table[(i & ~SECTION_MASK) >> PAGE_SHIFT] =
+				mmu_desc(i, memory_type) | PTE_TYPE_PAGE;
+	}
 }
 
 /* to activate the MMU we need to set up virtual memory */
 void mmu_setup(void)
 {
-	u64 i, j, el;
+	u64 i, el;
 	bd_t *bd = gd->bd;
 	u64 *page_table = (u64 *)gd->arch.tlb_addr;
 
 	/* Setup an identity-mapping for all spaces */
-	for (i = 0; i < (PGTABLE_SIZE >> 3); i++) {
+	mmu_l3_tables = 0;
+	for (i = 0; i < PMD_TABLE_ENTRIES; i++) {
 		set_pgtable_section(page_table, i, i << SECTION_SHIFT,
 				    MT_DEVICE_NGNRNE);
 	}
 
-	/* Setup an identity-mapping for all RAM space */
+	/* Setup an identity-mapping for all RAM space, up to its real end */
 	for (i = 0; i < CONFIG_NR_DRAM_BANKS; i++) {
 		ulong start = bd->bi_dram[i].start;
 		/* plus CONFIG_SYS_MEM_TOP_HIDE, for all ddr need cached */
@@ -48,25 +125,15 @@ void mmu_setup(void)
 #else
 		ulong end = bd->bi_dram[i].start + bd->bi_dram[i].size;
 #endif
-		end &= 0xF8000000;
-		if ((end >> (SECTION_SHIFT-2)) & 1) {
-			/* odd multiple of 128MB, align to 256M */
-			end += (SECTION_SIZE>>2);
-		}
-		if ((end >> (SECTION_SHIFT-1)) & 1) {
-			/* odd multiple of 256MB, align to 512M */
-			end += (SECTION_SIZE>>1);
-		}
-		printf("mmu cfg end: 0x%lx\n", end);
-		if (end == 0x100000000) {
-			end -= SECTION_SIZE;
-		}
-		printf("mmu cfg end: 0x%lx\n", end);
-		for (j = start >> SECTION_SHIFT; j < end >> SECTION_SHIFT; j++) {
-			set_pgtable_section(page_table, j, j << SECTION_SHIFT, MT_NORMAL);
-		}
+		debug("mmu cfg bank %llu: 0x%lx - 0x%lx\n", i, start, end);
+		mmu_map_range(page_table, start, end, MT_NORMAL);
 	}
 
+	/* then the regions given their own cache setting */
+	for (i = 0; i < mmu_nr_regions; i++)
+		mmu_map_range(page_table, mmu_regions[i].start,
+			      mmu_regions[i].end, mmu_regions[i].memory_type);
+
 	/* load TTBR0 */
 	el = current_el();
 	if (el == 1) {
@@ -86,6 +153,56 @@ void mmu_setup(void)
 	set_sctlr(get_sctlr() | CR_M);
 }
 
+void mmu_set_region_dcache_behaviour(phys_addr_t start, size_t size,
+				     enum dcache_option option)
+{
+	struct mmu_region *region;
+	int i;
+
+	for (i = 0; i < mmu_nr_regions; i++)
+		if (mmu_regions[i].start == start &&
+		    mmu_regions[i].end == start + size)
+			break;
+	if (i == MMU_MAX_REGIONS) {
+		printf("%s: no room for 0x%llx\n", __func__, (u64)start);
+		return;
+	}
+	if (i == mmu_nr_regions)
+		mmu_nr_regions++;
+	region = &mmu_regions[i];
+	region->start = start;
+	region->end = start + size;
+	region->memory_type = option;
+
+	/*
+	 * Rebuild the tables with the mmu off rather than split a live
+	 * section, which the architecture wants done break-before-make.
+	 */
+	if (dcache_status()) {
+		dcache_disable();
+		dcache_enable();
+	}
+}
+
+/*
+ * Nothing cached to maintain in a DCACHE_OFF region. The barrier that ends
+ * the maintenance is still issued: callers rely on it to make their writes
+ * visible to a device before starting it with a register write.
+ */
+static int mmu_range_noncached(unsigned long start, unsigned long stop)
+{
+	int i;
+
+	for (i = 0; i < mmu_nr_regions; i++)
+		if (mmu_regions[i].memory_type == MT_NORMAL_NC &&
+		    start >= mmu_regions[i].start &&
+		    stop <= mmu_regions[i].end) {
+			__asm__ volatile("dsb sy" : : : "memory");
+			return 1;
+		}
+	return 0;
+}
+
 /*
  * Performs a invalidation of the entire data cache at all levels
  */
@@ -112,6 +229,8 @@ void flush_dcache_all(void)
  */
 void invalidate_dcache_range(unsigned long start, unsigned long stop)
 {
+	if (mmu_range_noncached(start, stop))
+		return;
 	__asm_flush_dcache_range(start, stop);
 }
 
@@ -120,6 +239,8 @@ void invalidate_dcache_range(unsigned long start, unsigned long stop)
  */
 void flush_dcache_range(unsigned long start, unsigned long stop)
 {
+	if (mmu_range_noncached(start, stop))
+		return;
 	__asm_flush_dcache_range(start, stop);
 }
 
@@ -188,6 +309,11 @@ int dcache_status(void)
 	return 0;
 }
 
+void mmu_set_region_dcache_behaviour(phys_addr_t start, size_t size,
+				     enum dcache_option option)
+{
+}
+
 #endif	/* CONFIG_SYS_DCACHE_OFF */
 
 #ifndef CONFIG_SYS_ICACHE_OFF
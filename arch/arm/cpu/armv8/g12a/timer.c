@@ -31,6 +31,14 @@ uint32_t get_time(void)
 	return readl(P_EE_TIMER_E);
 }
 
+#ifdef CONFIG_BOOTSTAGE
+/* timer E counts microseconds from power on, so bootstage includes bl2 */
+unsigned long timer_get_boot_us(void)
+{
+	return get_time();
+}
+#endif
+
 void _udelay(unsigned int us)
 {
 #ifndef CONFIG_PXP_EMULATOR
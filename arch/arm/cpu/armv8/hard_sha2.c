@@ -176,6 +176,8 @@ static void SHA2_HW_update(sha2_ctx *ctx, const uint8_t *data, uint32_t len)
 	/* fill saved block from beginning of input data */
 	if (ctx->len) {
 		fill_len = SHA256_BLOCK_SIZE - ctx->len;
+		if (fill_len > data_len)
+			fill_len = data_len;
 		memcpy(&ctx->block[ctx->len], data, fill_len);
 		/* after mempcy,must flush data to ddr */
 		flush_dcache_range((unsigned long)ctx->block,(unsigned long)ctx->block+128);
@@ -243,6 +245,9 @@ void sha256_update(sha256_context *ctx, const uint8_t *input, uint32_t length)
 	int nOffset = 0;
 	int nStep = (128<<19) ; //64MB
 
+	/* the engine reads the input from ddr */
+	flush_dcache_range((unsigned long)input,(unsigned long)input+length);
+
 	if (length > nStep)
 	{
 			for (;nOffset< length;)
@@ -271,8 +276,6 @@ void sha256_finish(sha256_context * ctx, uint8_t digest[SHA256_SUM_LEN])
 void sha256_csum_wd(const unsigned char *input, unsigned int ilen,
 		unsigned char *output, unsigned int chunk_sz)
 {
-	flush_dcache_range((unsigned long)input,(unsigned long)input+ilen);
-
 	sha2_ctx sha_ctx;
 
 	sha256_starts(&sha_ctx);
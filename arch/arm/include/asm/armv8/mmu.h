@@ -35,6 +35,10 @@
 #define SECTION_SHIFT		29
 #define SECTION_SIZE		(UL(1) << SECTION_SHIFT)
 #define SECTION_MASK		(~(SECTION_SIZE-1))
+
+/* entries of the level 2 table, and of a level 3 table of pages */
+#define PMD_TABLE_ENTRIES	(UL(1) << (VA_BITS - SECTION_SHIFT))
+#define PTE_TABLE_ENTRIES	(UL(1) << (SECTION_SHIFT - PAGE_SHIFT))
 /***************************************************************/
 
 /*
@@ -45,12 +49,14 @@
 #define MT_DEVICE_GRE		2
 #define MT_NORMAL_NC		3
 #define MT_NORMAL		4
+#define MT_NORMAL_WT		5
 
 #define MEMORY_ATTRIBUTES	((0x00 << (MT_DEVICE_NGNRNE*8)) |	\
 				(0x04 << (MT_DEVICE_NGNRE*8)) |		\
 				(0x0c << (MT_DEVICE_GRE*8)) |		\
 				(0x44 << (MT_NORMAL_NC*8)) |		\
-				(UL(0xff) << (MT_NORMAL*8)))
+				(UL(0xff) << (MT_NORMAL*8)) |		\
+				(UL(0xbb) << (MT_NORMAL_WT*8)))
 
 /*
  * Hardware page table definitions.
@@ -62,6 +68,11 @@
 #define PMD_TYPE_TABLE		(3 << 0)
 #define PMD_TYPE_SECT		(1 << 0)
 
+/*
+ * Level 3 descriptor (PTE), same attributes as a section.
+ */
+#define PTE_TYPE_PAGE		(3 << 0)
+
 /*
  * Section
  */
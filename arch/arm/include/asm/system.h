@@ -14,7 +14,14 @@
 #define CR_WXN		(1 << 19)	/* Write Permision Imply XN	*/
 #define CR_EE		(1 << 25)	/* Exception (Big) Endian	*/
 
-#define PGTABLE_SIZE	(0x10000)
+/*
+ * The level 2 table, then level 3 tables of 64KB pages for the 512MB
+ * sections only partly DRAM or holding a non-cacheable region.
+ */
+#ifndef CONFIG_SYS_MMU_L3_TABLES
+#define CONFIG_SYS_MMU_L3_TABLES	4
+#endif
+#define PGTABLE_SIZE	(0x10000 * (1 + CONFIG_SYS_MMU_L3_TABLES))
 
 #ifndef __ASSEMBLY__
 
@@ -80,6 +87,37 @@ void smp_kick_all_cpus(void);
 
 void flush_l3_cache(void);
 
+/* options available for data cache on each page, the MAIR index */
+enum dcache_option {
+	DCACHE_OFF = 3,			/* MT_NORMAL_NC */
+	DCACHE_WRITETHROUGH = 5,	/* MT_NORMAL_WT */
+	DCACHE_WRITEBACK = 4,		/* MT_NORMAL */
+	DCACHE_WRITEALLOC = 4,		/* MT_NORMAL */
+};
+
+/* Smallest region the MMU maps, a 64KB page */
+enum {
+	MMU_SECTION_SHIFT	= 16,
+	MMU_SECTION_SIZE	= 1 << MMU_SECTION_SHIFT,
+};
+
+/**
+ * Change the cache settings for a region. The page tables are rebuilt
+ * with the MMU off, the setting stays over dcache off/on. Cache
+ * maintenance on a DCACHE_OFF region is skipped.
+ *
+ * \param start		start address of memory region to change
+ * \param size		size of memory region to change
+ * \param option	dcache option to select
+ */
+void mmu_set_region_dcache_behaviour(phys_addr_t start, size_t size,
+				     enum dcache_option option);
+
+#ifdef CONFIG_SYS_NONCACHED_MEMORY
+void noncached_init(void);
+phys_addr_t noncached_alloc(size_t size, size_t align);
+#endif /* CONFIG_SYS_NONCACHED_MEMORY */
+
 #endif	/* __ASSEMBLY__ */
 
 #else /* CONFIG_ARM64 */
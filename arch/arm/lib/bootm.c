@@ -25,6 +25,9 @@
 #include <bootm.h>
 #include <vxworks.h>
 #include <asm/arch/timer.h>
+#ifdef CONFIG_AML_DISPLAY_ASYNC
+#include <amlogic/display_async.h>
+#endif
 
 #if defined(CONFIG_ARMV7_NONSEC) || defined(CONFIG_ARMV7_VIRT)
 #include <asm/armv7.h>
@@ -83,6 +86,9 @@ static void announce_and_cleanup(int fake)
 
 #ifdef CONFIG_USB_DEVICE
 	udc_disconnect();
+#endif
+#ifdef CONFIG_AML_DISPLAY_ASYNC
+	display_async_sync();
 #endif
 	cleanup_before_linux();
 }
@@ -56,6 +56,9 @@
 
 #define CONFIG_CMD_BOOTCTOL_AVB
 
+//use hardware sha2 for avb and fit hashing
+#define CONFIG_AML_HW_SHA2
+
 /* support ext4*/
 #define CONFIG_CMD_EXT4 1
 
@@ -349,6 +352,7 @@
 #define CONFIG_ANDROID_BOOT_IMAGE 1
 #define CONFIG_ANDROID_IMG 1
 #define CONFIG_SYS_BOOTM_LEN (64<<20) /* Increase max gunzip size*/
+#define CONFIG_IMGREAD_STREAM_LOAD 1 /* imgread kernel: read boot.img in 4M chunks */
 
 /* cpu */
 #define CONFIG_CPU_CLK					1200 //MHz. Range: 360-2000, should be multiple of 24
@@ -373,6 +377,9 @@
 #define		CONFIG_STORE_COMPATIBLE 1
 #define 	CONFIG_ENV_OVERWRITE
 #define 	CONFIG_CMD_SAVEENV
+/* emmc: saveenv appends changed variables to a log behind the env */
+#define		CONFIG_ENV_LOG
+#define		CONFIG_ENV_LOG_SIZE		(64*1024)
 /* fixme, need fix*/
 
 #if (defined(CONFIG_ENV_IS_IN_AMLNAND) || defined(CONFIG_ENV_IS_IN_MMC)) && defined(CONFIG_STORE_COMPATIBLE)
@@ -418,6 +425,9 @@
 #define CONFIG_BL2_COPY_NUM               4
 #endif /* CONFIG_DISCRETE_BOOTLOADER */
 
+/* vendor read retry, learnt retry levels kept in the "nrrt" rsv area */
+#define CONFIG_AML_MTD_NEW_NAND 1
+
 #define CONFIG_CMD_NAND 1
 #define CONFIG_MTD_DEVICE y
 /* mtd parts of ourown.*/
@@ -447,6 +457,8 @@
 #ifdef		CONFIG_AML_SD_EMMC
 	#define 	CONFIG_GENERIC_MMC 1
 	#define 	CONFIG_CMD_MMC 1
+	#define 	CONFIG_CMD_MMC_BENCH 1
+	#define CONFIG_AML_SD_EMMC_CHAIN_DESC 64 /* up to ~16MB per read/write */
 	#define CONFIG_CMD_GPT 1
 	#define	CONFIG_SYS_MMC_ENV_DEV 1
 	#define CONFIG_EMMC_DDR52_EN 0
@@ -466,6 +478,8 @@
 #endif
 /* SPI flash config */
 #ifdef CONFIG_AML_SPIFC
+	/* read through the memory mapped window */
+	#define CONFIG_SPIFC_AHB_READ
 	#define CONFIG_SPI_FLASH
 	#define CONFIG_DM_SPI_FLASH
 	#define CONFIG_CMD_SF
@@ -520,6 +534,8 @@
 #define CONFIG_AML_LCD    1
 #define CONFIG_AML_LCD_TABLET 1
 #define CONFIG_AML_LCD_EXTERN 1
+/* lcd power sequence and backlight delays overlap with loading */
+#define CONFIG_AML_DISPLAY_ASYNC 1
 
 /* USB
  * Enable CONFIG_MUSB_HCD for Host functionalities MSC, keyboard
@@ -560,6 +576,7 @@
 #define CONFIG_USBDOWNLOAD_GADGET 1
 #define CONFIG_SYS_CACHELINE_SIZE 64
 #define CONFIG_FASTBOOT_MAX_DOWN_SIZE	0x8000000
+#define CONFIG_FASTBOOT_FLASH_STREAM	1	//oem stream: flash while downloading
 #define CONFIG_DEVICE_PRODUCT	"fermi"
 
 //UBOOT Facotry usb/sdcard burning config
@@ -567,6 +584,7 @@
 #define CONFIG_AML_FACTORY_BURN_LOCAL_UPGRADE   1       //support factory sdcard burning
 #define CONFIG_POWER_KEY_NOT_SUPPORTED_FOR_BURN 1       //There isn't power-key for factory sdcard burning
 #define CONFIG_SD_BURNING_SUPPORT_UI            1       //Displaying upgrading progress bar when sdcard/udisk burning
+#define CONFIG_SD_BURNING_UI_UPDATE_MS          500     //redraw the progress bar at most every 500ms while burning
 
 #define CONFIG_AML_SECURITY_KEY                 1
 #define CONFIG_UNIFY_KEY_MANAGE                 1
@@ -620,6 +638,13 @@
 #define CONFIG_CMD_JTAG	1
 #define CONFIG_CMD_AUTOSCRIPT 1
 #define CONFIG_CMD_MISC 1
+#define CONFIG_CMD_UNZIP 1
+#define CONFIG_CMD_DECOMP_BENCH 1
+#define CONFIG_CMD_MEMPERF 1
+#define CONFIG_CMD_BOOTSTAGE 1
+/* parse boot scripts once, time their commands */
+#define CONFIG_HUSH_PARSE_CACHE 1
+#define CONFIG_HUSH_PROFILE 1
 
 /*file system*/
 #define CONFIG_DOS_PARTITION 1
@@ -629,12 +654,26 @@
 #define CONFIG_FS_FAT 1
 #define CONFIG_FS_EXT4 1
 #define CONFIG_LZO 1
+#define CONFIG_LZ4 1
 
 #define CONFIG_MDUMP_COMPRESS 1
 
+/* boot time of store, decompress, hash and fdt fixup, passed to kernel */
+#define CONFIG_BOOTSTAGE 1
+#define CONFIG_BOOTSTAGE_FDT 1
+
+/* AArch64 string routines, instead of the generic C ones */
+#define CONFIG_USE_ARCH_MEMCPY 1
+#define CONFIG_USE_ARCH_MEMSET 1
+#define CONFIG_USE_ARCH_MEMMOVE 1
+#define CONFIG_USE_ARCH_MEMCMP 1
+#define CONFIG_USE_ARCH_STRLEN 1
+
 /* Cache Definitions */
 //#define CONFIG_SYS_DCACHE_OFF
 //#define CONFIG_SYS_ICACHE_OFF
+/* uncached DMA descriptors, no cache maintenance per transfer */
+#define CONFIG_SYS_NONCACHED_MEMORY	(1 << 20)
 
 /* other functions */
 #define CONFIG_NEED_BL301	1
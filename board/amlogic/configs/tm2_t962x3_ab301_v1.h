@@ -443,6 +443,8 @@
 	#define	CONFIG_SYS_MMC_ENV_DEV 1
 	#define CONFIG_EMMC_DDR52_EN 0
 	#define CONFIG_EMMC_DDR52_CLK 35000000
+	/* hs400, tuning result cached in the "tuning" rsv area */
+	#define CONFIG_EMMC_HS400 1
     /* !! For tm2 revA ONLY !!*/
     #define CONFIG_EMMC_KEEP_BOOT1 1
 #endif
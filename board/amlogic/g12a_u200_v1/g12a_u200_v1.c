@@ -319,6 +319,13 @@ static void board_mmc_register(unsigned port)
 	aml_priv->sd_emmc_pwr_off=sd_emmc_pwr_off;
 	aml_priv->sd_emmc_pwr_on=sd_emmc_pwr_on;
 	aml_priv->sd_emmc_pwr_prepare=sd_emmc_pwr_prepare;
+#ifdef CONFIG_SYS_NONCACHED_MEMORY
+	/* fetched by the host on every command, keep it out of the cache */
+	aml_priv->desc_buf = (char *)noncached_alloc(
+		NEWSD_MAX_DESC_MUN * sizeof(struct sd_emmc_desc_info),
+		ARCH_DMA_MINALIGN);
+	if (NULL == aml_priv->desc_buf)
+#endif
 	aml_priv->desc_buf = malloc(NEWSD_MAX_DESC_MUN*(sizeof(struct sd_emmc_desc_info)));
 
 	if (NULL == aml_priv->desc_buf)
@@ -536,10 +543,28 @@ static int spifc_pinctrl_enable(void *pinctrl, bool enable)
 	return 0;
 }
 
+#ifdef CONFIG_SPIFC_AHB_READ
+/* BOOT_14 as NOR_CS for the memory mapped reads, else gpio */
+static int spifc_cs_hw_enable(void *pinctrl, bool enable)
+{
+	unsigned int val;
+
+	val = readl(P_PERIPHS_PIN_MUX_1);
+	val &= ~(0xf << 24);
+	if (enable)
+		val |= 0x3 << 24;
+	writel(val, P_PERIPHS_PIN_MUX_1);
+	return 0;
+}
+#endif
+
 static const struct spifc_platdata spifc_platdata = {
 	.reg = 0xffd14000,
 	.mem_map = 0xf6000000,
 	.pinctrl_enable = spifc_pinctrl_enable,
+#ifdef CONFIG_SPIFC_AHB_READ
+	.cs_hw_enable = spifc_cs_hw_enable,
+#endif
 	.num_chipselect = SPIFC_NUM_CS,
 	.cs_gpios = spifc_cs_gpios,
 };
@@ -45,6 +45,49 @@
 #ifndef CONFIG_FASTBOOT_FLASH_FILLBUF_SIZE
 #define CONFIG_FASTBOOT_FLASH_FILLBUF_SIZE (1024 * 512)
 #endif
+
+/* write @blkcnt blocks of @fill_val at @blk, return the blocks advanced */
+static lbaint_t write_sparse_fill(struct sparse_storage *info, lbaint_t blk,
+		lbaint_t blkcnt, uint32_t fill_val)
+{
+	int fill_buf_num_blks = CONFIG_FASTBOOT_FLASH_FILLBUF_SIZE / info->blksz;
+	uint32_t *fill_buf;
+	lbaint_t blks, blk_start = blk;
+	int i, j;
+
+	fill_buf = (uint32_t *)
+		   memalign(ARCH_DMA_MINALIGN,
+			    ROUNDUP(info->blksz * fill_buf_num_blks,
+				    ARCH_DMA_MINALIGN));
+	if (!fill_buf) {
+		fastboot_fail("Malloc failed for: CHUNK_TYPE_FILL");
+		return -1;
+	}
+
+	for (i = 0; i < (info->blksz * fill_buf_num_blks / sizeof(fill_val)); i++)
+		fill_buf[i] = fill_val;
+
+	for (i = 0; i < blkcnt;) {
+		j = blkcnt - i;
+		if (j > fill_buf_num_blks)
+			j = fill_buf_num_blks;
+		blks = info->write(info, blk, j, fill_buf);
+		/* blks might be > j (eg. NAND bad-blocks) */
+		if (blks < j) {
+			printf("%s: %s " LBAFU " [%d]\n", __func__,
+			       "Write failed, block #", blk, j);
+			fastboot_fail("flash write failure");
+			free(fill_buf);
+			return -1;
+		}
+		blk += blks;
+		i += j;
+	}
+
+	free(fill_buf);
+	return blk - blk_start;
+}
+
 int write_sparse_image(
 		struct sparse_storage *info, const char *part_name,
 		void *data, unsigned sz)
@@ -55,16 +98,11 @@ int write_sparse_image(
 	uint64_t bytes_written = 0;
 	unsigned int chunk;
 	uint64_t chunk_data_sz;
-	uint32_t *fill_buf = NULL;
 	uint32_t fill_val;
 	sparse_header_t *sparse_header;
 	chunk_header_t *chunk_header;
 	uint32_t total_blocks = 0;
-	int fill_buf_num_blks;
-	int i;
-	int j;
 
-	fill_buf_num_blks = CONFIG_FASTBOOT_FLASH_FILLBUF_SIZE / info->blksz;
 	/* Read and skip over sparse image header */
 	sparse_header = (sparse_header_t *) data;
 
@@ -169,27 +207,9 @@ int write_sparse_image(
 				return -1;
 			}
 
-			fill_buf = (uint32_t *)
-				   memalign(ARCH_DMA_MINALIGN,
-					    ROUNDUP(
-						info->blksz * fill_buf_num_blks,
-						    ARCH_DMA_MINALIGN));
-			if (!fill_buf)
-			{
-				fastboot_fail(
-					"Malloc failed for: CHUNK_TYPE_FILL");
-				return -1;
-			}
-
 			fill_val = *(uint32_t *)data;
 			data = (char *) data + sizeof(uint32_t);
 
-			for (i = 0;
-			     i < (info->blksz * fill_buf_num_blks /
-				  sizeof(fill_val));
-			     i++)
-				fill_buf[i] = fill_val;
-
 			if (blk + blkcnt > info->start + info->size) {
 				printf(
 				    "%s: Request would exceed partition size!\n",
@@ -199,29 +219,12 @@ int write_sparse_image(
 				return -1;
 			}
 
-			for (i = 0; i < blkcnt;) {
-				j = blkcnt - i;
-				if (j > fill_buf_num_blks)
-					j = fill_buf_num_blks;
-				blks = info->write(info, blk, j, fill_buf);
-				/* blks might be > j (eg. NAND bad-blocks) */
-				if (blks < j) {
-					printf("%s: %s " LBAFU " [%d]\n",
-					       __func__,
-					       "Write failed, block #",
-					       blk, j);
-					fastboot_fail(
-						      "flash write failure");
-					free(fill_buf);
-					return -1;
-				}
-				blk += blks;
-				i += j;
-			}
+			blks = write_sparse_fill(info, blk, blkcnt, fill_val);
+			if (blks == (lbaint_t)-1)
+				return -1;
+			blk += blks;
 			bytes_written += blkcnt * info->blksz;
 			total_blocks += chunk_data_sz / sparse_header->blk_sz;
-
-			free(fill_buf);
 			break;
 
 			case CHUNK_TYPE_DONT_CARE:
@@ -261,3 +264,158 @@ int write_sparse_image(
 		return 0;
 	}
 }
+
+#ifdef CONFIG_FASTBOOT_FLASH_STREAM
+void write_sparse_stream_init(struct sparse_storage *info,
+		struct sparse_stream *st)
+{
+	memset(st, 0, sizeof(*st));
+	st->blk = info->start;
+}
+
+/*
+ * Write the sparse image data [@data, @data + @sz) which follows the data
+ * already written, *@used is set to the bytes disposed. The rest (a partial
+ * header or block) must be passed again at the head of the next call.
+ */
+int write_sparse_image_stream(struct sparse_storage *info,
+		struct sparse_stream *st, void *data, unsigned sz,
+		unsigned *used)
+{
+	sparse_header_t *sparse_header = &st->header;
+	char *p = data;
+	char *end = p + sz;
+	chunk_header_t chunk_header;
+	uint64_t chunk_data_sz;
+	lbaint_t blkcnt, blks;
+
+	if (!st->header_done) {
+		if (sz < sizeof(sparse_header_t))
+			goto out;
+		memcpy(sparse_header, p, sizeof(sparse_header_t));
+		if (sz < sparse_header->file_hdr_sz)
+			goto out;
+		if (sparse_header->blk_sz !=
+		    (sparse_header->blk_sz & ~(info->blksz - 1))) {
+			printf("%s: Sparse image block size issue [%u]\n",
+			       __func__, sparse_header->blk_sz);
+			fastboot_fail("sparse image block size issue");
+			return -1;
+		}
+		p += sparse_header->file_hdr_sz;
+		st->header_done = 1;
+		puts("Flashing Sparse Image\n");
+	}
+
+	for (;;) {
+		/* data of a RAW chunk, written in whole blocks as it comes */
+		if (st->raw_left) {
+			uint64_t n = min_t(uint64_t, st->raw_left, end - p);
+
+			blkcnt = n / info->blksz;
+			if (!blkcnt)
+				break;
+			if (st->blk + blkcnt > info->start + info->size) {
+				fastboot_fail("Request would exceed partition size!");
+				return -1;
+			}
+			blks = info->write(info, st->blk, blkcnt, p);
+			if (blks < blkcnt) {
+				printf("%s: Write failed " LBAFU "\n", __func__, blks);
+				fastboot_fail("flash write failure");
+				return -1;
+			}
+			st->blk += blks;
+			st->raw_left -= blkcnt * info->blksz;
+			st->bytes_written += blkcnt * info->blksz;
+			p += blkcnt * info->blksz;
+			continue;
+		}
+
+		if (st->chunk >= sparse_header->total_chunks) {
+			p = end;	/* ignore trailing data */
+			break;
+		}
+		if (end - p < sparse_header->chunk_hdr_sz)
+			break;
+		memcpy(&chunk_header, p, sizeof(chunk_header_t));
+		chunk_data_sz = (uint64_t)sparse_header->blk_sz * chunk_header.chunk_sz;
+		blkcnt = chunk_data_sz / info->blksz;
+		if (st->blk + blkcnt > info->start + info->size) {
+			fastboot_fail("Request would exceed partition size!");
+			return -1;
+		}
+
+		switch (chunk_header.chunk_type) {
+		case CHUNK_TYPE_RAW:
+			if (chunk_header.total_sz !=
+			    (sparse_header->chunk_hdr_sz + chunk_data_sz)) {
+				fastboot_fail("Bogus chunk size for chunk type Raw");
+				return -1;
+			}
+			st->raw_left = chunk_data_sz;
+			break;
+
+		case CHUNK_TYPE_FILL:
+			if (chunk_header.total_sz !=
+			    (sparse_header->chunk_hdr_sz + sizeof(uint32_t))) {
+				fastboot_fail("Bogus chunk size for chunk type FILL");
+				return -1;
+			}
+			if (end - p < chunk_header.total_sz)
+				goto out;
+			blks = write_sparse_fill(info, st->blk, blkcnt,
+				*(uint32_t *)(p + sparse_header->chunk_hdr_sz));
+			if (blks == (lbaint_t)-1)
+				return -1;
+			st->blk += blks;
+			st->bytes_written += blkcnt * info->blksz;
+			break;
+
+		case CHUNK_TYPE_DONT_CARE:
+			if (chunk_header.total_sz != sparse_header->chunk_hdr_sz) {
+				fastboot_fail("Bogus chunk size for chunk type Dont Care");
+				return -1;
+			}
+			st->blk += info->reserve(info, st->blk, blkcnt);
+			break;
+
+		case CHUNK_TYPE_CRC32:
+			if (end - p < chunk_header.total_sz)
+				goto out;
+			break;
+
+		default:
+			printf("%s: Unknown chunk type: %x\n", __func__,
+			       chunk_header.chunk_type);
+			fastboot_fail("Unknown chunk type");
+			return -1;
+		}
+
+		/* RAW data follows the header, others are all in total_sz */
+		p += (chunk_header.chunk_type == CHUNK_TYPE_RAW) ?
+			sparse_header->chunk_hdr_sz : chunk_header.total_sz;
+		st->total_blocks += chunk_header.chunk_sz;
+		st->chunk++;
+	}
+
+out:
+	*used = p - (char *)data;
+	return 0;
+}
+
+int write_sparse_stream_end(struct sparse_stream *st, const char *part_name)
+{
+	printf("........ wrote %llu bytes to '%s'\n", st->bytes_written, part_name);
+
+	if (!st->header_done || st->raw_left ||
+	    st->chunk != st->header.total_chunks ||
+	    st->total_blocks != st->header.total_blks) {
+		fastboot_fail("sparse image write failure");
+		return -1;
+	}
+
+	fastboot_okay("");
+	return 0;
+}
+#endif /* CONFIG_FASTBOOT_FLASH_STREAM */
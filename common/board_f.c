@@ -546,6 +546,23 @@ static int reserve_malloc(void)
 	return 0;
 }
 
+#ifdef CONFIG_SYS_NONCACHED_MEMORY
+/*
+ * keep the noncached_alloc() area clear of what follows: noncached_init()
+ * puts it below the malloc() area, these calculations must match
+ */
+static int reserve_noncached(void)
+{
+	gd->start_addr_sp = ALIGN(gd->start_addr_sp, MMU_SECTION_SIZE) -
+		MMU_SECTION_SIZE;
+	gd->start_addr_sp -= ALIGN(CONFIG_SYS_NONCACHED_MEMORY,
+				   MMU_SECTION_SIZE);
+	debug("Reserving %dk for noncached_alloc() at: %08lx\n",
+	      CONFIG_SYS_NONCACHED_MEMORY >> 10, gd->start_addr_sp);
+	return 0;
+}
+#endif
+
 /* (permanently) allocate a Board Info struct */
 static int reserve_board(void)
 {
@@ -990,6 +1007,9 @@ static init_fnc_t init_sequence_f[] = {
 #endif
 #ifndef CONFIG_SPL_BUILD
 	reserve_malloc,
+#ifdef CONFIG_SYS_NONCACHED_MEMORY
+	reserve_noncached,
+#endif
 	reserve_board,
 #endif
 	setup_machine,
@@ -20,6 +20,7 @@
 #include <lzma/LzmaTypes.h>
 #include <lzma/LzmaDec.h>
 #include <lzma/LzmaTools.h>
+#include <lz4.h>
 #include <android_image.h>
 #if defined(CONFIG_CMD_USB)
 #include <usb.h>
@@ -541,7 +542,7 @@ static int bootm_find_other(cmd_tbl_t *cmdtp, int flag, int argc,
  * @image_buf:	Address to decompress from
  * @return 0 if OK, -ve on error (BOOTM_ERR_...)
  */
-static int decomp_image(int comp, ulong load, ulong image_start, int type,
+static int _decomp_image(int comp, ulong load, ulong image_start, int type,
 			void *load_buf, void *image_buf, ulong image_len,
 			ulong *load_end)
 {
@@ -627,6 +628,23 @@ static int decomp_image(int comp, ulong load, ulong image_start, int type,
 		break;
 	}
 #endif /* CONFIG_LZO */
+#ifdef CONFIG_LZ4
+	case IH_COMP_LZ4: {
+		size_t size = unc_len;
+		int ret;
+
+		printf("   Uncompressing %s ... ", type_name);
+		ret = ulz4fn(image_buf, image_len, load_buf, &size);
+		if (ret) {
+			printf("LZ4: uncompress or overwrite error %d - must RESET board to recover\n",
+			       ret);
+			return BOOTM_ERR_RESET;
+		}
+
+		*load_end = load + size;
+		break;
+	}
+#endif /* CONFIG_LZ4 */
 	default:
 		printf("Unimplemented compression type %d\n", comp);
 		return BOOTM_ERR_UNIMPLEMENTED;
@@ -637,6 +655,21 @@ static int decomp_image(int comp, ulong load, ulong image_start, int type,
 	return 0;
 }
 
+static int decomp_image(int comp, ulong load, ulong image_start, int type,
+			void *load_buf, void *image_buf, ulong image_len,
+			ulong *load_end)
+{
+	int ret;
+
+	bootstage_start(BOOTSTAGE_ID_ACCUM_DECOMP, "decompress");
+	ret = _decomp_image(comp, load, image_start, type, load_buf,
+			    image_buf, image_len, load_end);
+	bootstage_accum_data(BOOTSTAGE_ID_ACCUM_DECOMP,
+			     ret ? 0 : *load_end - load);
+
+	return ret;
+}
+
 #ifndef USE_HOSTCC
 static int bootm_load_os(bootm_headers_t *images, unsigned long *load_end,
 			 int boot_progress)
@@ -14,6 +14,7 @@
 
 #include <common.h>
 #include <libfdt.h>
+#include <fdt_support.h>
 #include <malloc.h>
 #include <linux/compiler.h>
 
@@ -25,6 +26,8 @@ struct bootstage_record {
 	const char *name;
 	int flags;		/* see enum bootstage_flags */
 	enum bootstage_id id;
+	uint32_t count;		/* number of accumulated activities */
+	uint64_t bytes;		/* data processed by accumulated activities */
 };
 
 static struct bootstage_record record[BOOTSTAGE_ID_COUNT] = { {1} };
@@ -137,6 +140,7 @@ uint32_t bootstage_start(enum bootstage_id id, const char *name)
 
 	rec->start_us = timer_get_boot_us();
 	rec->name = name;
+	rec->id = id;
 	return rec->start_us;
 }
 
@@ -147,9 +151,16 @@ uint32_t bootstage_accum(enum bootstage_id id)
 
 	duration = (uint32_t)timer_get_boot_us() - rec->start_us;
 	rec->time_us += duration;
+	rec->count++;
 	return duration;
 }
 
+uint32_t bootstage_accum_data(enum bootstage_id id, ulong bytes)
+{
+	record[id].bytes += bytes;
+	return bootstage_accum(id);
+}
+
 /**
  * Get a record name as a printable string
  *
@@ -188,9 +199,26 @@ static uint32_t print_time_record(enum bootstage_id id,
 	return rec->time_us;
 }
 
+static void print_accum_record(struct bootstage_record *rec)
+{
+	char buf[20];
+	ulong us = rec->time_us ? rec->time_us : 1;
+
+	printf("%11s", "");
+	print_grouped_ull(rec->time_us, BOOTSTAGE_DIGITS);
+	printf("  %s, %u times", get_record_name(buf, sizeof(buf), rec),
+	       rec->count);
+	/* bytes per us is MB/s */
+	if (rec->bytes)
+		printf(", %llu KiB, %llu.%02llu MB/s", rec->bytes >> 10,
+		       rec->bytes / us, rec->bytes % us * 100 / us);
+	puts("\n");
+}
+
 static int h_compare_record(const void *r1, const void *r2)
 {
-	const struct bootstage_record *rec1 = r1, *rec2 = r2;
+	const struct bootstage_record *rec1 = *(struct bootstage_record * const *)r1;
+	const struct bootstage_record *rec2 = *(struct bootstage_record * const *)r2;
 
 	return rec1->time_us > rec2->time_us ? 1 : -1;
 }
@@ -204,8 +232,9 @@ static int h_compare_record(const void *r1, const void *r2)
  */
 static int add_bootstages_devicetree(struct fdt_header *blob)
 {
-	int bootstage;
 	char buf[20];
+	char path[24];
+	int own_batch;
 	int id;
 	int i;
 
@@ -216,38 +245,53 @@ static int add_bootstages_devicetree(struct fdt_header *blob)
 	 * Create the node for bootstage.
 	 * The address of flat device tree is set up by the command bootm.
 	 */
-	bootstage = fdt_add_subnode(blob, 0, "bootstage");
-	if (bootstage < 0)
+	if (fdt_subnode_offset(blob, 0, "bootstage") >= 0)
 		return -1;
 
+	/*
+	 * The nodes and properties are queued and written in one pass,
+	 * instead of moving the blob for every one of them.
+	 */
+	own_batch = !fdt_batch_begin(blob);
+
 	/*
 	 * Insert the timings to the device tree in the reverse order so
 	 * that they can be printed in the Linux kernel in the right order.
 	 */
 	for (id = BOOTSTAGE_ID_COUNT - 1, i = 0; id >= 0; id--, i++) {
 		struct bootstage_record *rec = &record[id];
-		int node;
 
 		if (id != BOOTSTAGE_ID_AWAKE && rec->time_us == 0)
 			continue;
 
-		node = fdt_add_subnode(blob, bootstage, simple_itoa(i));
-		if (node < 0)
-			break;
+		snprintf(path, sizeof(path), "/bootstage/%d", i);
 
 		/* add properties to the node. */
-		if (fdt_setprop_string(blob, node, "name",
+		if (fdt_batch_setprop_string(blob, path, "name",
 				get_record_name(buf, sizeof(buf), rec)))
-			return -1;
+			goto err;
 
 		/* Check if this is a 'mark' or 'accum' record */
-		if (fdt_setprop_cell(blob, node,
+		if (fdt_batch_setprop_u32(blob, path,
 				rec->start_us ? "accum" : "mark",
 				rec->time_us))
-			return -1;
+			goto err;
+
+		if (rec->count &&
+		    fdt_batch_setprop_u32(blob, path, "count", rec->count))
+			goto err;
+		if (rec->bytes &&
+		    fdt_batch_setprop_u64(blob, path, "bytes", rec->bytes))
+			goto err;
 	}
 
+	if (own_batch && fdt_batch_commit(blob))
+		return -1;
 	return 0;
+err:
+	if (own_batch)
+		fdt_batch_abort();
+	return -1;
 }
 
 int bootstage_fdt_add_report(void)
@@ -261,6 +305,8 @@ int bootstage_fdt_add_report(void)
 
 void bootstage_report(void)
 {
+	/* sorted view, record[] stays indexed by id for later accumulation */
+	static struct bootstage_record *sorted[BOOTSTAGE_ID_COUNT];
 	struct bootstage_record *rec = record;
 	int id;
 	uint32_t prev;
@@ -274,9 +320,12 @@ void bootstage_report(void)
 	prev = print_time_record(BOOTSTAGE_ID_AWAKE, rec, 0);
 
 	/* Sort records by increasing time */
-	qsort(record, ARRAY_SIZE(record), sizeof(*rec), h_compare_record);
+	for (id = 0; id < BOOTSTAGE_ID_COUNT; id++)
+		sorted[id] = &record[id];
+	qsort(sorted, ARRAY_SIZE(sorted), sizeof(*sorted), h_compare_record);
 
-	for (id = 0; id < BOOTSTAGE_ID_COUNT; id++, rec++) {
+	for (id = 0; id < BOOTSTAGE_ID_COUNT; id++) {
+		rec = sorted[id];
 		if (rec->time_us != 0 && !rec->start_us)
 			prev = print_time_record(rec->id, rec, prev);
 	}
@@ -288,7 +337,7 @@ void bootstage_report(void)
 	puts("\nAccumulated time:\n");
 	for (id = 0, rec = record; id < BOOTSTAGE_ID_COUNT; id++, rec++) {
 		if (rec->start_us)
-			prev = print_time_record(id, rec, -1);
+			print_accum_record(rec);
 	}
 }
 
@@ -307,6 +307,35 @@ struct variables *top_vars = &shell_ver;
 static int flag_repeat = 0;
 static int do_repeat = 0;
 static struct variables *top_vars = NULL ;
+#ifdef CONFIG_HUSH_PARSE_CACHE
+#ifndef CONFIG_HUSH_PARSE_CACHE_SIZE
+#define CONFIG_HUSH_PARSE_CACHE_SIZE	8
+#endif
+/* parsed scripts ("run" and friends), reused while their text is the same */
+struct parse_cache {
+	char *text;
+	size_t len;
+	int flag;
+	int busy;				/* running, nested runs too */
+	ulong used;
+	struct pipe *list;
+};
+static struct parse_cache parse_cache[CONFIG_HUSH_PARSE_CACHE_SIZE];
+static ulong parse_cache_used;
+#endif
+#ifdef CONFIG_HUSH_PROFILE
+#ifndef CONFIG_HUSH_PROFILE_SIZE
+#define CONFIG_HUSH_PROFILE_SIZE	32
+#endif
+/* time spent per command, nested commands included */
+struct hush_prof {
+	const char *name;
+	uint count;
+	ulong time_us;
+	ulong max_us;
+};
+static struct hush_prof hush_prof[CONFIG_HUSH_PROFILE_SIZE];
+#endif
 #endif /*__U_BOOT__ */
 
 #define B_CHUNK (100)
@@ -447,6 +476,9 @@ static int run_list_real(struct pipe *pi);
 static void pseudo_exec(struct child_prog *child) __attribute__ ((noreturn));
 #endif
 static int run_pipe_real(struct pipe *pi);
+#ifdef CONFIG_HUSH_PROFILE
+static int hush_prof_process(int flag, int argc, char * const argv[]);
+#endif
 /*   extended glob support: */
 #ifndef __U_BOOT__
 static int globhack(const char *src, int flags, glob_t *pglob);
@@ -1653,8 +1685,12 @@ static int run_pipe_real(struct pipe *pi)
 			return -1;
 		}
 		/* Process the command */
+#ifdef CONFIG_HUSH_PROFILE
+		return hush_prof_process(flag, child->argc, child->argv);
+#else
 		return cmd_process(flag, child->argc, child->argv,
 				   &flag_repeat, NULL);
+#endif
 #endif
 	}
 #ifndef __U_BOOT__
@@ -1749,6 +1785,9 @@ static int run_list_real(struct pipe *pi)
 #endif
 	int rcode=0, flag_skip=1;
 	int flag_restore = 0;
+#ifdef CONFIG_HUSH_PARSE_CACHE
+	int save_sp;
+#endif
 	int if_code=0, next_if_code=0;  /* need double-buffer to handle elif */
 	reserved_style rmode, skip_more_in_this_rmode=RES_XXXX;
 	/* check syntax for "for" */
@@ -1850,8 +1889,15 @@ static int run_list_real(struct pipe *pi)
 		if (pi->num_progs == 0) continue;
 #ifndef __U_BOOT__
 		save_num_progs = pi->num_progs; /* save number of programs */
+#endif
+#ifdef CONFIG_HUSH_PARSE_CACHE
+		/* run_pipe_real() eats ->sp, a cached list runs again */
+		save_sp = pi->progs->sp;
 #endif
 		rcode = run_pipe_real(pi);
+#ifdef CONFIG_HUSH_PARSE_CACHE
+		pi->progs->sp = save_sp;
+#endif
 		debug_printf("run_pipe_real returned %d\n",rcode);
 #ifndef __U_BOOT__
 		if (rcode!=-1) {
@@ -3153,6 +3199,127 @@ static void update_ifs_map(void)
 	mapset(ifs, 2);            /* also flow through if quoted */
 }
 
+#ifdef CONFIG_HUSH_PARSE_CACHE
+/* a list can be run again unless a for loop leaves its argv swapped */
+static int parse_cache_ok(struct pipe *pi)
+{
+	int i;
+
+	for (; pi; pi = pi->next) {
+		if (pi->r_mode == RES_FOR)
+			return 0;
+		for (i = 0; i < pi->num_progs; i++)
+			if (pi->progs[i].group &&
+			    !parse_cache_ok(pi->progs[i].group))
+				return 0;
+	}
+	return 1;
+}
+
+static struct parse_cache *parse_cache_find(const char *text, int flag)
+{
+	struct parse_cache *pc;
+	size_t len = strlen(text);
+
+	for (pc = parse_cache; pc < parse_cache + ARRAY_SIZE(parse_cache); pc++) {
+		if (pc->list && pc->flag == flag && pc->len == len &&
+		    !memcmp(pc->text, text, len)) {
+			pc->used = ++parse_cache_used;
+			return pc;
+		}
+	}
+	return NULL;
+}
+
+/* keep @list parsed from @text, NULL if it can't be: then run_list() it */
+static struct parse_cache *parse_cache_add(const char *text, int flag,
+					   struct pipe *list)
+{
+	struct parse_cache *pc, *lru = NULL;
+
+	if (!parse_cache_ok(list))
+		return NULL;
+	for (pc = parse_cache; pc < parse_cache + ARRAY_SIZE(parse_cache); pc++) {
+		if (!pc->busy && (!lru || pc->used < lru->used))
+			lru = pc;
+	}
+	if (!lru)
+		return NULL;
+	if (lru->list) {
+		free_pipe_list(lru->list, 0);
+		free(lru->text);
+		lru->list = NULL;
+	}
+	lru->text = strdup(text);
+	if (!lru->text)
+		return NULL;
+	lru->len = strlen(text);
+	lru->flag = flag;
+	lru->used = ++parse_cache_used;
+	lru->list = list;
+	return lru;
+}
+
+static int parse_cache_run(struct parse_cache *pc)
+{
+	int code;
+
+	pc->busy++;
+	code = run_list_real(pc->list);
+	pc->busy--;
+	return code;
+}
+#endif
+
+#ifdef CONFIG_HUSH_PROFILE
+static int hush_prof_process(int flag, int argc, char * const argv[])
+{
+	struct hush_prof *hp;
+	cmd_tbl_t *cmdtp;
+	ulong start, us;
+	int rcode;
+
+	start = timer_get_boot_us();
+	rcode = cmd_process(flag, argc, argv, &flag_repeat, NULL);
+	us = timer_get_boot_us() - start;
+
+	cmdtp = find_cmd(argv[0]);
+	if (!cmdtp || !(gd->flags & GD_FLG_RELOC))
+		return rcode;
+	for (hp = hush_prof; hp < hush_prof + ARRAY_SIZE(hush_prof); hp++) {
+		if (!hp->name || hp->name == cmdtp->name)
+			break;
+	}
+	if (hp == hush_prof + ARRAY_SIZE(hush_prof))
+		return rcode;
+	hp->name = cmdtp->name;
+	hp->count++;
+	hp->time_us += us;
+	if (us > hp->max_us)
+		hp->max_us = us;
+	return rcode;
+}
+
+void hush_prof_report(void)
+{
+	struct hush_prof *hp;
+
+	printf("%-16s %8s %12s %10s\n", "command", "count", "total us",
+	       "max us");
+	for (hp = hush_prof; hp < hush_prof + ARRAY_SIZE(hush_prof); hp++) {
+		if (!hp->name)
+			break;
+		printf("%-16s %8u %12lu %10lu\n", hp->name, hp->count,
+		       hp->time_us, hp->max_us);
+	}
+}
+
+void hush_prof_reset(void)
+{
+	memset(hush_prof, 0, sizeof(hush_prof));
+}
+#endif
+
 /* most recursion does not come through here, the exeception is
  * from builtin_source() */
 static int parse_stream_outer(struct in_str *inp, int flag)
@@ -3163,6 +3330,25 @@ static int parse_stream_outer(struct in_str *inp, int flag)
 	int rcode;
 #ifdef __U_BOOT__
 	int code = 1;
+#endif
+#ifdef CONFIG_HUSH_PARSE_CACHE
+	struct parse_cache *pc;
+	const char *text = NULL;
+
+	/* a whole script ("run"): parse it once, run the same list after */
+	if ((gd->flags & GD_FLG_RELOC) && (flag & FLAG_CONT_ON_NEWLINE) &&
+	    inp->peek == static_peek) {
+		pc = parse_cache_find(inp->p, flag);
+		if (pc) {
+			code = parse_cache_run(pc);
+			if (code == -2)		/* exit */
+				code = 0;
+			else if (code == -1)
+				flag_repeat = 0;
+			return (code != 0) ? 1 : 0;
+		}
+		text = inp->p;
+	}
 #endif
 	do {
 		ctx.type = flag;
@@ -3170,8 +3356,14 @@ static int parse_stream_outer(struct in_str *inp, int flag)
 		update_ifs_map();
 		if (!(flag & FLAG_PARSE_SEMICOLON) || (flag & FLAG_REPARSING)) mapset((uchar *)";$&|", 0);
 		inp->promptmode=1;
+#ifdef __U_BOOT__
+		bootstage_start(BOOTSTAGE_ID_ACCUM_HUSH_PARSE, "hush_parse");
+#endif
 		rcode = parse_stream(&temp, &ctx, inp,
 				     flag & FLAG_CONT_ON_NEWLINE ? -1 : '\n');
+#ifdef __U_BOOT__
+		bootstage_accum(BOOTSTAGE_ID_ACCUM_HUSH_PARSE);
+#endif
 #ifdef __U_BOOT__
 		if (rcode == 1) flag_repeat = 0;
 #endif
@@ -3187,6 +3379,13 @@ static int parse_stream_outer(struct in_str *inp, int flag)
 #ifndef __U_BOOT__
 			run_list(ctx.list_head);
 #else
+#ifdef CONFIG_HUSH_PARSE_CACHE
+			pc = text ? parse_cache_add(text, flag, ctx.list_head) :
+				NULL;
+			if (pc)
+				code = parse_cache_run(pc);
+			else
+#endif
 			code = run_list(ctx.list_head);
 			if (code == -2) {	/* exit */
 				b_free(&temp);
@@ -34,6 +34,9 @@ Description:
 #include <anti-rollback.h>
 #endif
 #include <amlogic/aml_efuse.h>
+#ifdef CONFIG_AML_DISPLAY_ASYNC
+#include <amlogic/display_async.h>
+#endif
 
 #define AVB_USE_TESTKEY
 #define MAX_DTB_SIZE (AML_DTB_IMG_MAX_SZ + 512)
@@ -58,7 +61,7 @@ extern const int avb2_kpub_default_len;
 
 AvbOps avb_ops_;
 
-static AvbIOResult read_from_partition(AvbOps* ops, const char* partition, int64_t offset,
+static AvbIOResult read_partition(AvbOps* ops, const char* partition, int64_t offset,
         size_t num_bytes, void* buffer, size_t* out_num_read)
 {
     int rc = 0;
@@ -100,6 +103,73 @@ static AvbIOResult read_from_partition(AvbOps* ops, const char* partition, int64
     return AVB_IO_RESULT_OK;
 }
 
+static AvbIOResult read_from_partition(AvbOps* ops, const char* partition, int64_t offset,
+        size_t num_bytes, void* buffer, size_t* out_num_read)
+{
+    AvbIOResult ret;
+
+    avb_stats_start(AVB_STATS_READ);
+    ret = read_partition(ops, partition, offset, num_bytes, buffer, out_num_read);
+    avb_stats_end(AVB_STATS_READ, partition,
+            ret == AVB_IO_RESULT_OK ? *out_num_read : 0);
+#ifdef CONFIG_AML_DISPLAY_ASYNC
+    display_async_poll();
+#endif
+
+    return ret;
+}
+
+/*
+ * A partition the caller already read into its final place, e.g. boot
+ * by "imgread kernel". avb_verify() hashes it there instead of reading
+ * it again into a heap buffer.
+ */
+static struct {
+    char name[32];
+    uint8_t *addr;
+    size_t loaded;      /* bytes from the partition start already at addr */
+    size_t capacity;    /* bytes usable at addr */
+} avb_preload;
+
+void avb_set_preloaded_partition(const char *partition, void *addr,
+        size_t loaded, size_t capacity)
+{
+    memset(&avb_preload, 0, sizeof(avb_preload));
+    if (!partition || !addr || strlen(partition) >= sizeof(avb_preload.name))
+        return;
+
+    strcpy(avb_preload.name, partition);
+    avb_preload.addr = addr;
+    avb_preload.loaded = loaded;
+    avb_preload.capacity = capacity;
+}
+
+static AvbIOResult get_preloaded_partition(AvbOps* ops, const char* partition,
+        size_t num_bytes, uint8_t** out_pointer, size_t* out_num_bytes_preloaded)
+{
+    AvbIOResult ret;
+    size_t num_read;
+
+    *out_pointer = NULL;
+    *out_num_bytes_preloaded = 0;
+    if (strcmp(partition, avb_preload.name) || num_bytes > avb_preload.capacity)
+        return AVB_IO_RESULT_OK;
+
+    /* signed size may cover a bit more than the caller needed, e.g. padding */
+    if (num_bytes > avb_preload.loaded) {
+        ret = read_from_partition(ops, partition, avb_preload.loaded,
+                num_bytes - avb_preload.loaded,
+                avb_preload.addr + avb_preload.loaded, &num_read);
+        if (ret != AVB_IO_RESULT_OK)
+            return ret;
+        avb_preload.loaded = num_bytes;
+    }
+
+    *out_pointer = avb_preload.addr;
+    *out_num_bytes_preloaded = num_bytes;
+    return AVB_IO_RESULT_OK;
+}
+
 static AvbIOResult write_to_partition(AvbOps* ops, const char* partition,
         int64_t offset, size_t num_bytes, const void* buffer)
 {
@@ -343,7 +413,7 @@ static int avb_init(void)
 
     memset(&avb_ops_, 0, sizeof(AvbOps));
     avb_ops_.read_from_partition = read_from_partition;
-    avb_ops_.get_preloaded_partition = NULL;
+    avb_ops_.get_preloaded_partition = get_preloaded_partition;
     avb_ops_.write_to_partition = write_to_partition;
     avb_ops_.validate_vbmeta_public_key = validate_vbmeta_public_key;
     avb_ops_.read_rollback_index = read_rollback_index;
@@ -393,6 +463,7 @@ int avb_verify(AvbSlotVerifyData** out_data)
     char *upgradestep = NULL;
 
     avb_init();
+    avb_stats_reset();
 
     upgradestep = getenv("upgrade_step");
 
@@ -415,6 +486,9 @@ int avb_verify(AvbSlotVerifyData** out_data)
     result = avb_slot_verify(&avb_ops_, requested_partitions, ab_suffix,
             flags,
             AVB_HASHTREE_ERROR_MODE_RESTART_AND_INVALIDATE, out_data);
+    bootstage_mark_name(BOOTSTAGE_ID_ALLOC, "avb_verify");
+    /* only trust the memory for the verification right after the load */
+    avb_set_preloaded_partition(NULL, NULL, 0, 0);
 
     if (!strcmp(upgradestep, "3"))
         result = AVB_SLOT_VERIFY_RESULT_OK;
@@ -464,8 +538,29 @@ static int do_avb_verify(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv
     return result;
 }
 
+static int do_avb_stats(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
+{
+    avb_stats_print();
+    return 0;
+}
+
+static int do_avb_hashbench(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
+{
+    ulong addr, len;
+
+    if (argc != 3)
+        return CMD_RET_USAGE;
+
+    addr = simple_strtoul(argv[1], NULL, 16);
+    len = simple_strtoul(argv[2], NULL, 16);
+    avb_sha_bench((const uint8_t *)addr, len);
+    return 0;
+}
+
 static cmd_tbl_t cmd_avb_sub[] = {
     U_BOOT_CMD_MKENT(verify, 4, 0, do_avb_verify, "", ""),
+    U_BOOT_CMD_MKENT(stats, 1, 0, do_avb_stats, "", ""),
+    U_BOOT_CMD_MKENT(hashbench, 3, 0, do_avb_hashbench, "", ""),
 };
 
 static int do_avb_ops(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
@@ -488,7 +583,10 @@ static int do_avb_ops(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 
 
 U_BOOT_CMD(
-        avb, 2, 0, do_avb_ops,
+        avb, 4, 0, do_avb_ops,
         "avb",
         "\nThis command will trigger related avb operations\n"
+        "avb verify - verify the current slot\n"
+        "avb stats  - read/hash time per partition of the last verify\n"
+        "avb hashbench addr len - sha256/sha512 throughput of each backend\n"
         );
@@ -5,6 +5,9 @@
  */
 
 #include <common.h>
+#ifdef CONFIG_HUSH_PROFILE
+#include <cli_hush.h>
+#endif
 
 #ifndef CONFIG_BOOTSTAGE_STASH
 #define CONFIG_BOOTSTAGE_STASH		-1UL
@@ -63,8 +66,24 @@ static int do_bootstage_stash(cmd_tbl_t *cmdtp, int flag, int argc,
 	return 0;
 }
 
+#ifdef CONFIG_HUSH_PROFILE
+static int do_bootstage_script(cmd_tbl_t *cmdtp, int flag, int argc,
+			       char * const argv[])
+{
+	if (argc > 1 && !strcmp(argv[1], "reset"))
+		hush_prof_reset();
+	else
+		hush_prof_report();
+
+	return 0;
+}
+#endif
+
 static cmd_tbl_t cmd_bootstage_sub[] = {
 	U_BOOT_CMD_MKENT(report, 2, 1, do_bootstage_report, "", ""),
+#ifdef CONFIG_HUSH_PROFILE
+	U_BOOT_CMD_MKENT(script, 2, 1, do_bootstage_script, "", ""),
+#endif
 	U_BOOT_CMD_MKENT(stash, 4, 0, do_bootstage_stash, "", ""),
 	U_BOOT_CMD_MKENT(unstash, 4, 0, do_bootstage_stash, "", ""),
 };
@@ -95,6 +114,9 @@ U_BOOT_CMD(bootstage, 4, 1, do_boostage,
 	"Boot stage command",
 	" - check boot progress and timing\n"
 	"report                      - Print a report\n"
+#ifdef CONFIG_HUSH_PROFILE
+	"script [reset]              - Print [reset] time per script command\n"
+#endif
 	"stash [<start> [<size>]]    - Stash data into memory\n"
 	"unstash [<start> [<size>]]  - Unstash data from memory"
 );
@@ -47,7 +47,7 @@ partition_name: env / logo / recovery /boot / system /cache /media
 
  ***/
 
-int store_read_ops(unsigned char *partition_name,unsigned char * buf, uint64_t off, uint64_t size)
+static int _store_read_ops(unsigned char *partition_name,unsigned char * buf, uint64_t off, uint64_t size)
 {
         unsigned char *name;
         uint64_t addr;
@@ -112,7 +112,7 @@ partition_name: env / logo / recovery /boot / system /cache /media
 
  ***/
 
-int store_write_ops(unsigned char *partition_name,unsigned char * buf, uint64_t off, uint64_t size)
+static int _store_write_ops(unsigned char *partition_name,unsigned char * buf, uint64_t off, uint64_t size)
 {
         unsigned char *name;
         uint64_t addr;
@@ -170,6 +170,28 @@ int store_write_ops(unsigned char *partition_name,unsigned char * buf, uint64_t
 }
 
 
+int store_read_ops(unsigned char *partition_name,unsigned char * buf, uint64_t off, uint64_t size)
+{
+        int ret;
+
+        bootstage_start(BOOTSTAGE_ID_ACCUM_STORE_READ, "store_read");
+        ret = _store_read_ops(partition_name, buf, off, size);
+        bootstage_accum_data(BOOTSTAGE_ID_ACCUM_STORE_READ, ret ? 0 : size);
+
+        return ret;
+}
+
+int store_write_ops(unsigned char *partition_name,unsigned char * buf, uint64_t off, uint64_t size)
+{
+        int ret;
+
+        bootstage_start(BOOTSTAGE_ID_ACCUM_STORE_WRITE, "store_write");
+        ret = _store_write_ops(partition_name, buf, off, size);
+        bootstage_accum_data(BOOTSTAGE_ID_ACCUM_STORE_WRITE, ret ? 0 : size);
+
+        return ret;
+}
+
 /***
 upgrade_write_ops:
 
@@ -68,6 +68,9 @@ static struct color_attr_to_string color_attr_lut[] =
       { COLOR_ATTR_RGB_8BIT,        "rgb,8bit"  },
 };
 
+/* hdmitx_device.rawedid holds the sink's EDID, read since the last hpd */
+static int edid_cached;
+
 static int do_hpd_detect(cmd_tbl_t *cmdtp, int flag, int argc,
 	char *const argv[])
 {
@@ -94,6 +97,7 @@ static int do_hpd_detect(cmd_tbl_t *cmdtp, int flag, int argc,
 #endif
 
 	st = hdmitx_device.HWOp.get_hpd_state();
+	edid_cached = 0;
 	printf("hpd_state=%c\n", st ? '1' : '0');
 
 	/*get hdmi mode and colorattribute from env */
@@ -683,15 +687,41 @@ static int selectBestMode(struct rx_cap *pRXCap, bool isAuto, int manualMode)
 	return HDMI_1920x1080p60_16x9; //default
 }
 
-static int do_get_parse_edid(cmd_tbl_t * cmdtp, int flag, int argc,
-	char * const argv[])
+/*
+ * The sink's EDID is read over DDC 8 bytes at a time, each read waiting
+ * ms for the transfer, so the raw EDID is read once and shared by
+ * get_preferred_mode and get_parse_edid until the next hpd.
+ */
+static int hdmitx_read_parse_edid(struct hdmitx_dev *hdev)
 {
-	struct hdmitx_dev *hdev = &hdmitx_device;
 	unsigned int byte_num = 0;
 	unsigned char *edid = hdev->rawedid;
 	unsigned char blk_no = 1;
-	unsigned char *store_checkvalue;
+
+	if (edid_cached)
+		return hdmi_edid_parsing(hdev->rawedid, &hdev->RXCap);
+
 	memset(edid, 0, EDID_BLK_SIZE * EDID_BLK_NO);
+	/* Read complete EDID data sequentially */
+	while (byte_num < 128 * blk_no) {
+		hdev->HWOp.read_edid(&edid[byte_num], byte_num & 0x7f, byte_num / 128);
+		if (byte_num == 120) {
+			blk_no = edid[126] + 1;
+			if (blk_no > 4)
+				blk_no = 4; /* MAX Read Blocks 4 */
+		}
+		byte_num += 8;
+	}
+
+	edid_cached = 1;
+	return hdmi_edid_parsing(hdev->rawedid, &hdev->RXCap);
+}
+
+static int do_get_parse_edid(cmd_tbl_t * cmdtp, int flag, int argc,
+	char * const argv[])
+{
+	struct hdmitx_dev *hdev = &hdmitx_device;
+	unsigned char *store_checkvalue;
 	unsigned int i;
 	unsigned int checkvalue[4];
 	unsigned int checkvalue1;
@@ -706,17 +736,7 @@ static int do_get_parse_edid(cmd_tbl_t * cmdtp, int flag, int argc,
 	int inColorSpace = -1, inColorDepth = -1;
 	int bestColorAttributes = -1;
 
-	while (byte_num < 128 * blk_no) {
-		hdmitx_device.HWOp.read_edid(&edid[byte_num], byte_num & 0x7f, byte_num / 128);
-		if (byte_num == 120) {
-			blk_no = edid[126] + 1;
-			if (blk_no > 4)
-				blk_no = 4; /* MAX Read Blocks 4 */
-		}
-		byte_num += 8;
-	}
-
-	if (hdmi_edid_parsing(hdev->rawedid, &hdev->RXCap) == 0) {
+	if (hdmitx_read_parse_edid(hdev) == 0) {
 		dump_full_edid(hdev->rawedid);
 	}
 
@@ -861,9 +881,6 @@ static int do_get_preferred_mode(cmd_tbl_t * cmdtp, int flag, int argc,
 	char * const argv[])
 {
 	struct hdmitx_dev *hdev = &hdmitx_device;
-	unsigned int byte_num = 0;
-	unsigned char *edid = hdev->rawedid;
-	unsigned char blk_no = 1;
 	struct hdmi_format_para *para;
 	char pref_mode[64];
 	char color_attr[64];
@@ -875,7 +892,6 @@ static int do_get_preferred_mode(cmd_tbl_t * cmdtp, int flag, int argc,
 	if (hdmi_read_edid && (hdmi_read_edid[0] == '0'))
 		return 0;
 
-	memset(edid, 0, EDID_BLK_SIZE * EDID_BLK_NO);
 	memset(pref_mode, 0, sizeof(pref_mode));
 	memset(color_attr, 0, sizeof(color_attr));
 	memset(width, 0, sizeof(width));
@@ -891,21 +907,7 @@ static int do_get_preferred_mode(cmd_tbl_t * cmdtp, int flag, int argc,
 		goto bypass_edid_read;
 	}
 
-	/* Read complete EDID data sequentially */
-	while (byte_num < 128 * blk_no) {
-		hdmitx_device.HWOp.read_edid(&edid[byte_num], byte_num & 0x7f, byte_num / 128);
-		if (byte_num == 120) {
-			blk_no = edid[126] + 1;
-			if (blk_no > 4)
-				blk_no = 4; /* MAX Read Blocks 4 */
-		}
-		byte_num += 8;
-	}
-
-	if (hdmi_edid_parsing(hdev->rawedid, &hdev->RXCap) == 0) {
-		if (0)
-			dump_full_edid(hdev->rawedid);
-	}
+	hdmitx_read_parse_edid(hdev);
 	para = hdmi_get_fmt_paras(hdev->RXCap.preferred_mode);
 
 	if (para) {
@@ -28,6 +28,10 @@ Description:
 #include <libfdt.h>
 
 #include <amlogic/aml_efuse.h>
+#include <libavb.h>
+#ifdef CONFIG_AML_DISPLAY_ASYNC
+#include <amlogic/display_async.h>
+#endif// #ifdef CONFIG_AML_DISPLAY_ASYNC
 
 typedef struct andr_img_hdr boot_img_hdr;
 
@@ -39,6 +43,18 @@ typedef struct andr_img_hdr boot_img_hdr;
 #define IMG_PRELOAD_SZ  (1U<<20) //Total read 1M at first to read the image header
 #define PIC_PRELOAD_SZ  (8U<<10) //Total read 4k at first to read the image header
 #define RES_OLD_FMT_READ_SZ (8U<<20)
+#define IMG_STREAM_CHUNK_SZ (4U<<20) //chunk size for streaming load of the left part of boot.img
+
+//timings of the last 'imgread kernel', in us
+typedef struct {
+    unsigned long   preloadUs;  //read IMG_PRELOAD_SZ header part
+    unsigned long   parseUs;    //parse android/secure header
+    unsigned long   readUs;     //read the left part
+    unsigned        totalSz;    //total bytes loaded
+    unsigned        chunkNum;   //number of store_read_ops for the left part
+}ImgReadStat_t;
+
+static ImgReadStat_t _imgReadStat;
 
 typedef struct __aml_enc_blk{
         unsigned int  nOffset;
@@ -296,6 +312,36 @@ static int do_image_read_dtb(cmd_tbl_t *cmdtp, int flag, int argc, char * const
 }
 
 
+//Read the left part of image in IMG_STREAM_CHUNK_SZ chunks if CONFIG_IMGREAD_STREAM_LOAD,
+//  or while the display bring-up is pending so its panel power sequence steps on in between the chunks,
+//  otherwise at once
+static int _imgread_read_left(const char* partName, unsigned char* buf, uint64_t flashReadOff, unsigned leftSz)
+{
+    unsigned thisSz = leftSz;
+    int rc = 0;
+
+    while (leftSz)
+    {
+#if defined(CONFIG_IMGREAD_STREAM_LOAD)
+        thisSz = min(leftSz, IMG_STREAM_CHUNK_SZ);
+#elif defined(CONFIG_AML_DISPLAY_ASYNC)
+        thisSz = display_async_pending() ? min(leftSz, IMG_STREAM_CHUNK_SZ) : leftSz;
+#endif
+        rc = store_read_ops((unsigned char*)partName, buf, flashReadOff, thisSz);
+        if (rc) return rc;
+        _imgReadStat.chunkNum += 1;
+#ifdef CONFIG_AML_DISPLAY_ASYNC
+        display_async_poll();
+#endif// #ifdef CONFIG_AML_DISPLAY_ASYNC
+
+        buf             += thisSz;
+        flashReadOff    += thisSz;
+        leftSz          -= thisSz;
+    }
+
+    return 0;
+}
+
 static int do_image_read_kernel(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 {
     unsigned    kernel_size;
@@ -309,10 +355,15 @@ static int do_image_read_kernel(cmd_tbl_t *cmdtp, int flag, int argc, char * con
     int rc = 0;
     uint64_t flashReadOff = 0;
     unsigned secureKernelImgSz = 0;
+    unsigned long tick = 0;
+    unsigned char* dstaddr = 0;
 #if defined(CONFIG_IMAGE_FORMAT_LEGACY)
     image_header_t *hdr;
 #endif
 
+    memset(&_imgReadStat, 0, sizeof(_imgReadStat));
+    avb_set_preloaded_partition(NULL, NULL, 0, 0);
+
     if (2 < argc) {
         loadaddr = (unsigned char*)simple_strtoul(argv[2], NULL, 16);
     }
@@ -333,12 +384,15 @@ static int do_image_read_kernel(cmd_tbl_t *cmdtp, int flag, int argc, char * con
 
     if (3 < argc) flashReadOff = simple_strtoull(argv[3], NULL, 0) ;
 
+    tick = timer_get_us();
     rc = store_read_ops((unsigned char*)partName, loadaddr, flashReadOff, IMG_PRELOAD_SZ);
     if (rc) {
         errorP("Fail to read 0x%xB from part[%s] at offset 0\n", IMG_PRELOAD_SZ, partName);
         return __LINE__;
     }
     flashReadOff += IMG_PRELOAD_SZ;
+    _imgReadStat.preloadUs = timer_get_us() - tick;
+    tick = timer_get_us();
 
 #if defined(CONFIG_IMAGE_FORMAT_LEGACY)
     //check image format for rtos
@@ -386,22 +440,69 @@ static int do_image_read_kernel(cmd_tbl_t *cmdtp, int flag, int argc, char * con
 #if defined(CONFIG_IMAGE_FORMAT_LEGACY)
 load_left:
 #endif
+    dstaddr = loadaddr;
+#ifdef CONFIG_ANDROID_BOOT_IMAGE
+    //compressed kernel will be decompressed over the image, and bootm has to move the whole image away first,
+    //so read the left part straight into the relocation buffer bootm will use, instead of memmove it later
+    if (IMAGE_FORMAT_ANDROID == genFmt && !secureKernelImgSz && !nCheckOffset
+            && android_image_reloc_required((ulong)loadaddr, hdr_addr))
+    {
+        unsigned char* relocBuf = (unsigned char*)android_image_alloc_reloc((ulong)loadaddr, hdr_addr);
+        if (relocBuf) {
+            memcpy(relocBuf, loadaddr, min(actualBootImgSz, IMG_PRELOAD_SZ));
+            dstaddr = relocBuf;
+            debugP("load to reloc addr %p\n", relocBuf);
+        }
+    }
+#endif// #ifdef CONFIG_ANDROID_BOOT_IMAGE
+    _imgReadStat.parseUs = timer_get_us() - tick;
+    _imgReadStat.totalSz = actualBootImgSz;
     if (actualBootImgSz > IMG_PRELOAD_SZ)
     {
         const unsigned leftSz = actualBootImgSz - IMG_PRELOAD_SZ;
 
         debugP("Left sz 0x%x\n", leftSz);
-        rc = store_read_ops((unsigned char*)partName, loadaddr + IMG_PRELOAD_SZ, flashReadOff, leftSz);
+        tick = timer_get_us();
+        rc = _imgread_read_left(partName, dstaddr + IMG_PRELOAD_SZ, flashReadOff, leftSz);
         if (rc) {
             errorP("Fail to read 0x%xB from part[%s] at offset 0x%x\n", leftSz, partName, IMG_PRELOAD_SZ);
             return __LINE__;
         }
+        _imgReadStat.readUs = timer_get_us() - tick;
     }
     debugP("totalSz=0x%x\n", actualBootImgSz);
 
     //because secure boot will use DMA which need disable MMU temp
     //here must update the cache, otherwise nand will fail (eMMC is OK)
-    flush_cache((unsigned long)loadaddr,(unsigned long)actualBootImgSz);
+    flush_cache((unsigned long)dstaddr,(unsigned long)actualBootImgSz);
+
+#ifdef CONFIG_ANDROID_BOOT_IMAGE
+    //plain image read from the partition start: let avb hash it where it is
+    if (IMAGE_FORMAT_ANDROID == genFmt && !secureKernelImgSz && !nCheckOffset
+            && (3 >= argc || !simple_strtoull(argv[3], NULL, 0)))
+        avb_set_preloaded_partition(partName, dstaddr, actualBootImgSz,
+                android_image_get_end(hdr_addr) - (ulong)hdr_addr);
+#endif// #ifdef CONFIG_ANDROID_BOOT_IMAGE
+
+    return 0;
+}
+
+//print timings of the last 'imgread kernel'
+static int do_image_read_stat(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
+{
+    const ImgReadStat_t* pStat = &_imgReadStat;
+    const unsigned long loadUs = pStat->preloadUs + pStat->readUs;
+
+    if (!pStat->totalSz) {
+        MsgP("no kernel loaded yet\n");
+        return CMD_RET_FAILURE;
+    }
+    printf("imgread kernel: total 0x%x bytes, left part in %u chunks\n", pStat->totalSz, pStat->chunkNum);
+    printf("  preload %8lu us\n", pStat->preloadUs);
+    printf("  parse   %8lu us\n", pStat->parseUs);
+    printf("  read    %8lu us\n", pStat->readUs);
+    if (loadUs)
+        printf("  flash   %8lu KB/s\n", (unsigned long)(((uint64_t)pStat->totalSz * 1000000 / loadUs) >> 10));
 
     return 0;
 }
@@ -688,6 +789,7 @@ static cmd_tbl_t cmd_imgread_sub[] = {
     U_BOOT_CMD_MKENT(dtb,    4, 0, do_image_read_dtb, "", ""),
     U_BOOT_CMD_MKENT(res,    3, 0, do_image_read_res, "", ""),
     U_BOOT_CMD_MKENT(pic,    4, 0, do_image_read_pic, "", ""),
+    U_BOOT_CMD_MKENT(stat,   1, 0, do_image_read_stat, "", ""),
 };
 
 static int do_image_read(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
@@ -719,7 +821,8 @@ U_BOOT_CMD(
    "imgread kernel  --- Read image in fomart IMAGE_FORMAT_ANDROID\n"
    "imgread dtb     --- Read dtb in fomart IMAGE_FORMAT_ANDROID\n"
    "imgread res     --- Read image packed by 'Amlogic resource packer'\n"
-   "imgread pic     --- Read one picture from Amlogic logo"
+   "imgread pic     --- Read one picture from Amlogic logo\n"
+   "imgread stat    --- Show per-phase timings of the last 'imgread kernel'\n"
    "    - e.g. \n"
    "        to read boot.img     from part boot     from flash: <imgread kernel boot loadaddr> \n"   //usage
    "        to read recovery.img from part recovery from flash: <imgread kernel recovery loadaddr $offset> \n"   //usage
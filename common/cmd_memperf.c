@@ -0,0 +1,135 @@
+/*
+ * Throughput of the string routines
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <malloc.h>
+
+#define MEMPERF_MIN_SIZE	64
+#define MEMPERF_DEF_SIZE	(4 << 20)
+#define MEMPERF_BYTES		(16 << 20)	/* per routine and size */
+
+enum {
+	MEMPERF_MEMCPY,
+	MEMPERF_MEMMOVE,
+	MEMPERF_MEMSET,
+	MEMPERF_BZERO,
+	MEMPERF_MEMCMP,
+	MEMPERF_STRLEN,
+	MEMPERF_COUNT,
+};
+
+static const char * const memperf_names[MEMPERF_COUNT] = {
+	"memcpy", "memmove", "memset", "memset0", "memcmp", "strlen",
+};
+
+/* time of @loops runs of routine @op on @len bytes, in us */
+static ulong memperf_run(int op, char *dst, char *src, ulong len, ulong loops)
+{
+	volatile ulong sink = 0;
+	ulong start, i;
+
+	start = timer_get_us();
+	for (i = 0; i < loops; i++) {
+		switch (op) {
+		case MEMPERF_MEMCPY:
+			memcpy(dst, src, len);
+			break;
+		case MEMPERF_MEMMOVE:
+			/* overlapping, backward */
+			memmove(dst + 8, dst, len - 8);
+			break;
+		case MEMPERF_MEMSET:
+			memset(dst, 0x5a, len);
+			break;
+		case MEMPERF_BZERO:
+			memset(dst, 0, len);
+			break;
+		case MEMPERF_MEMCMP:
+			sink += memcmp(dst, src, len);
+			break;
+		case MEMPERF_STRLEN:
+			sink += strlen(src);
+			break;
+		}
+	}
+
+	return timer_get_us() - start;
+}
+
+static int do_memperf(cmd_tbl_t *cmdtp, int flag, int argc,
+		      char * const argv[])
+{
+	ulong size = MEMPERF_DEF_SIZE, len, loops, us, mbps;
+	char *buf = NULL, *src, *dst;
+	int op, unaligned = 0;
+
+	if (argc > 1 && !strcmp(argv[1], "-u")) {
+		unaligned = 1;
+		argc--;
+		argv++;
+	}
+	if (argc > 2)
+		return CMD_RET_USAGE;
+	if (argc > 1)
+		size = simple_strtoul(argv[1], NULL, 16);
+	if (size < MEMPERF_MIN_SIZE)
+		size = MEMPERF_MIN_SIZE;
+
+	/* two buffers, one cache line of slack for the unaligned runs */
+	buf = memalign(ARCH_DMA_MINALIGN, 2 * size + 2 * ARCH_DMA_MINALIGN);
+	if (!buf) {
+		printf("no memory for 2 x 0x%lx bytes\n", size);
+		return CMD_RET_FAILURE;
+	}
+	src = buf;
+	dst = buf + size + ARCH_DMA_MINALIGN;
+	if (unaligned) {
+		src += 3;
+		dst += 5;
+	}
+	/* equal buffers, so memcmp compares all, and one long string */
+	memset(src, 'a', size - 1);
+	src[size - 1] = '\0';
+	memcpy(dst, src, size);
+
+	printf("%10s", "size");
+	for (op = 0; op < MEMPERF_COUNT; op++)
+		printf("%10s", memperf_names[op]);
+	puts("  (GB/s)\n");
+
+	for (len = MEMPERF_MIN_SIZE; len <= size; len <<= 2) {
+		loops = MEMPERF_BYTES / len;
+		printf("%10lu", len);
+		for (op = 0; op < MEMPERF_COUNT; op++) {
+			if (op == MEMPERF_STRLEN)
+				src[len - 1] = '\0';
+			us = memperf_run(op, dst, src, len, loops);
+			if (op == MEMPERF_STRLEN)
+				src[len - 1] = len < size ? 'a' : '\0';
+			if (op == MEMPERF_MEMMOVE || op == MEMPERF_MEMSET ||
+			    op == MEMPERF_BZERO)
+				memcpy(dst, src, size);
+			/* bytes per us are MB/s */
+			mbps = us ? (ulong)((u64)loops * len / us) : 0;
+			printf("%7lu.%02lu", mbps / 1000, mbps % 1000 / 10);
+		}
+		putc('\n');
+		if (ctrlc())
+			break;
+	}
+
+	free(buf);
+	return 0;
+}
+
+U_BOOT_CMD(
+	memperf,	3,	1,	do_memperf,
+	"measure memcpy/memmove/memset/memcmp/strlen throughput",
+	"[-u] [size]\n"
+	"    - run each routine on 64 bytes up to size (hex, default 4MB)\n"
+	"      and print GB/s, -u with misaligned buffers"
+);
@@ -340,6 +340,111 @@ static int do_mmc_write(cmd_tbl_t *cmdtp, int flag,
 
 	return (n == cnt) ? CMD_RET_SUCCESS : CMD_RET_FAILURE;
 }
+#ifdef CONFIG_CMD_MMC_BENCH
+#define MMC_BENCH_IOPS_BLKS	8	/* 4KB random accesses */
+#define MMC_BENCH_IOPS_LOOPS	512
+
+static void mmc_bench_report(const char *name, u32 bytes, ulong us, u32 ios)
+{
+	if (!us)
+		us = 1;
+	printf("%-10s 0x%08x bytes %8lu us %4lu.%02lu MB/s", name, bytes, us,
+	       bytes / us, (bytes % us) * 100 / us);
+	if (ios)
+		printf(" %lu IOPS", (ulong)ios * 1000000 / us);
+	puts("\n");
+}
+
+/*
+ * sequential and 4KB random read speed of blk# ~ blk#+cnt, and write speed
+ * with 'write', which only writes back the data just read from there.
+ */
+static int do_mmc_bench(cmd_tbl_t *cmdtp, int flag,
+			int argc, char * const argv[])
+{
+	struct mmc *mmc;
+	u32 blk, cnt, n, i, off, seed;
+	int wr = 0;
+	ulong tick;
+	void *addr;
+
+	if (argc < 4)
+		return CMD_RET_USAGE;
+	if (argc > 4) {
+		if (strcmp(argv[4], "write"))
+			return CMD_RET_USAGE;
+		wr = 1;
+	}
+
+	addr = (void *)simple_strtoul(argv[1], NULL, 16);
+	blk = simple_strtoul(argv[2], NULL, 16);
+	cnt = simple_strtoul(argv[3], NULL, 16);
+	if (cnt < MMC_BENCH_IOPS_BLKS)
+		return CMD_RET_USAGE;
+
+	mmc = init_mmc_device(curr_device, false);
+	if (!mmc)
+		return CMD_RET_FAILURE;
+	if (wr && mmc_getwp(mmc) == 1) {
+		printf("Error: card is write protected!\n");
+		return CMD_RET_FAILURE;
+	}
+
+	printf("mmc%d: %u bit bus%s, %u Hz, max %u blocks per request\n",
+	       curr_device, mmc->bus_width, mmc->ddr_mode ? " ddr" : "",
+	       mmc->clock, mmc->cfg->b_max);
+
+	tick = timer_get_us();
+	n = mmc->block_dev.block_read(curr_device, blk, cnt, addr);
+	tick = timer_get_us() - tick;
+	if (n != cnt)
+		return CMD_RET_FAILURE;
+	mmc_bench_report("seq read", cnt * mmc->read_bl_len, tick, 0);
+
+	if (wr) {
+		tick = timer_get_us();
+		n = mmc->block_dev.block_write(curr_device, blk, cnt, addr);
+		tick = timer_get_us() - tick;
+		if (n != cnt)
+			return CMD_RET_FAILURE;
+		mmc_bench_report("seq write", cnt * mmc->write_bl_len, tick, 0);
+	}
+
+	/* same pseudo random offsets for read and write */
+	seed = get_timer(0);
+	tick = timer_get_us();
+	for (off = seed, i = 0; i < MMC_BENCH_IOPS_LOOPS; i++) {
+		off = off * 1103515245 + 12345;
+		n = (off >> 8) % (cnt - MMC_BENCH_IOPS_BLKS + 1);
+		if (mmc->block_dev.block_read(curr_device, blk + n,
+				MMC_BENCH_IOPS_BLKS, addr + n * mmc->read_bl_len)
+				!= MMC_BENCH_IOPS_BLKS)
+			return CMD_RET_FAILURE;
+	}
+	tick = timer_get_us() - tick;
+	mmc_bench_report("rand read", MMC_BENCH_IOPS_LOOPS * MMC_BENCH_IOPS_BLKS *
+			 mmc->read_bl_len, tick, MMC_BENCH_IOPS_LOOPS);
+
+	if (wr) {
+		tick = timer_get_us();
+		for (off = seed, i = 0; i < MMC_BENCH_IOPS_LOOPS; i++) {
+			off = off * 1103515245 + 12345;
+			n = (off >> 8) % (cnt - MMC_BENCH_IOPS_BLKS + 1);
+			if (mmc->block_dev.block_write(curr_device, blk + n,
+					MMC_BENCH_IOPS_BLKS, addr + n * mmc->write_bl_len)
+					!= MMC_BENCH_IOPS_BLKS)
+				return CMD_RET_FAILURE;
+		}
+		tick = timer_get_us() - tick;
+		mmc_bench_report("rand write", MMC_BENCH_IOPS_LOOPS *
+				 MMC_BENCH_IOPS_BLKS * mmc->write_bl_len, tick,
+				 MMC_BENCH_IOPS_LOOPS);
+	}
+
+	return CMD_RET_SUCCESS;
+}
+#endif /* CONFIG_CMD_MMC_BENCH */
+
 static int do_mmc_erase(cmd_tbl_t *cmdtp, int flag,
 			int argc, char * const argv[])
 {
@@ -960,6 +1065,9 @@ static cmd_tbl_t cmd_mmc[] = {
 #endif
 	U_BOOT_CMD_MKENT(setdsr, 2, 0, do_mmc_setdsr, "", ""),
 	U_BOOT_CMD_MKENT(test,   5, 0, do_mmc_test,   "", ""),
+#ifdef CONFIG_CMD_MMC_BENCH
+	U_BOOT_CMD_MKENT(bench,  5, 0, do_mmc_bench,  "", ""),
+#endif
 };
 
 static int do_mmcops(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
@@ -1029,6 +1137,10 @@ U_BOOT_CMD(
 	"mmc setdsr <value> - set DSR register value\n"
 	"mmc test <blk_start> <blk_size> <times> - erase, read and write appointed\n"
 	" - Position and size multiple times\n"
+#ifdef CONFIG_CMD_MMC_BENCH
+	"mmc bench addr blk# cnt [write] - sequential and 4KB random speed\n"
+	" - write only writes back the data read from blk# ~ blk#+cnt\n"
+#endif
 	);
 
 /* Old command kept for compatibility. Same as 'mmc info' */
@@ -34,6 +34,7 @@ void screen_setcolor(unsigned int color);
 void screen_drawtextline(const GRFont* font, int x, int y, const char *s, bool bold);
 void screen_fillrect(int x, int y, int w, int h);
 void screen_update(void);
+int screen_update_throttled(unsigned int min_interval_ms);
 const GRFont* gr_sys_font(void);
 void set_fastboot_flag(int flag);
 
@@ -177,6 +178,9 @@ static int do_ui_update(cmd_tbl_t *cmdtp, int flag, int argc,
 	if (!ui_inited) {
 		printf("error: ui init first\n");
 		return -1;
+	} else if (argc > 1) {
+		/* progress loops: at most one frame per <ms> */
+		screen_update_throttled(simple_strtoul(argv[1], NULL, 10));
 	} else {
 		screen_update();
 	}
@@ -267,7 +271,8 @@ U_BOOT_CMD(
 	"ui setcolor  <color>                           - set color\n"
 	"ui text <lib_font> <string> <x y> [bold]       - fill text to framebuffer\n"
 	"ui rect <x y> <w h>                            - fill rect to framebuffer\n"
-	"ui update                                      - update framebuffer to screen\n"
+	"ui update [ms]                                 - update framebuffer to screen\n"
+	"                                                 [if ms passed since the last update]\n"
 	"uinit                                          - uinit device and free space\n"
 	"ui debug <level>                               - set log level\n"
 );
@@ -7,6 +7,110 @@
 
 #include <common.h>
 #include <command.h>
+#include <image.h>
+#include <linux/compiler.h>
+#include <bzlib.h>
+#include <linux/lzo.h>
+#include <lzma/LzmaTypes.h>
+#include <lzma/LzmaDec.h>
+#include <lzma/LzmaTools.h>
+#include <lz4.h>
+
+static const unsigned char gzip_magic[] = { 0x1f, 0x8b };
+static const unsigned char bzip2_magic[] = { 'B', 'Z', 'h' };
+static const unsigned char lzma_magic[] = { 0x5d, 0x00, 0x00 };
+static const unsigned char lzop_magic[] = {
+	0x89, 0x4c, 0x5a, 0x4f, 0x00, 0x0d, 0x0a, 0x1a, 0x0a
+};
+static const unsigned char lz4_magic[] = { 0x04, 0x22, 0x4d, 0x18 };
+static const unsigned char lz4_legacy_magic[] = { 0x02, 0x21, 0x4c, 0x18 };
+
+static const struct {
+	int comp;
+	const unsigned char *magic;
+	int magic_len;
+} unzip_magic[] = {
+	{ IH_COMP_GZIP,  gzip_magic,	   sizeof(gzip_magic) },
+	{ IH_COMP_BZIP2, bzip2_magic,	   sizeof(bzip2_magic) },
+	{ IH_COMP_LZMA,  lzma_magic,	   sizeof(lzma_magic) },
+	{ IH_COMP_LZO,   lzop_magic,	   sizeof(lzop_magic) },
+	{ IH_COMP_LZ4,   lz4_magic,	   sizeof(lz4_magic) },
+	{ IH_COMP_LZ4,   lz4_legacy_magic, sizeof(lz4_legacy_magic) },
+};
+
+static __maybe_unused int unzip_get_comp(const void *src)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(unzip_magic); i++) {
+		if (!memcmp(src, unzip_magic[i].magic, unzip_magic[i].magic_len))
+			return unzip_magic[i].comp;
+	}
+
+	return IH_COMP_NONE;
+}
+
+/*
+ * Uncompress @src with @comp, *@dst_len is the size of @dst on input and the
+ * uncompressed size on output. Return 0 if OK.
+ */
+static __maybe_unused int unzip_comp(int comp, void *dst, unsigned long *dst_len,
+		      void *src, unsigned long src_len)
+{
+	int ret = -1;
+
+	switch (comp) {
+#ifdef CONFIG_GZIP
+	case IH_COMP_GZIP:
+		ret = gunzip(dst, *dst_len, src, &src_len);
+		*dst_len = src_len;
+		break;
+#endif
+#ifdef CONFIG_BZIP2
+	case IH_COMP_BZIP2: {
+		unsigned int len = *dst_len;
+
+		ret = BZ2_bzBuffToBuffDecompress(dst, &len, src, src_len,
+			CONFIG_SYS_MALLOC_LEN < (4096 * 1024), 0);
+		*dst_len = len;
+		break;
+	}
+#endif
+#ifdef CONFIG_LZMA
+	case IH_COMP_LZMA: {
+		SizeT len = *dst_len;
+
+		ret = lzmaBuffToBuffDecompress(dst, &len, src, src_len);
+		*dst_len = len;
+		break;
+	}
+#endif
+#ifdef CONFIG_LZO
+	case IH_COMP_LZO: {
+		size_t len = *dst_len;
+
+		ret = lzop_decompress(src, src_len, dst, &len);
+		*dst_len = len;
+		break;
+	}
+#endif
+#ifdef CONFIG_LZ4
+	case IH_COMP_LZ4: {
+		size_t len = *dst_len;
+
+		ret = ulz4fn(src, src_len, dst, &len);
+		*dst_len = len;
+		break;
+	}
+#endif
+	default:
+		printf("Unsupported compression type %s\n",
+		       genimg_get_comp_name(comp));
+		break;
+	}
+
+	return ret;
+}
 
 static int do_unzip(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 {
@@ -25,6 +129,15 @@ static int do_unzip(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 			return CMD_RET_USAGE;
 	}
 
+#ifdef CONFIG_LZ4
+	/* lz4 frames end with an end mark, legacy lz4 has no end */
+	if (!memcmp((void *)src, lz4_magic, sizeof(lz4_magic))) {
+		src_len = dst_len;
+		if (unzip_comp(IH_COMP_LZ4, (void *)dst, &src_len, (void *)src,
+			       ~0UL - src) != 0)
+			return 1;
+	} else
+#endif
 	if (gunzip((void *) dst, dst_len, (void *) src, &src_len) != 0)
 		return 1;
 
@@ -39,3 +152,59 @@ U_BOOT_CMD(
 	"unzip a memory region",
 	"srcaddr dstaddr [dstsize]"
 );
+
+#ifdef CONFIG_CMD_DECOMP_BENCH
+static int do_decomp_bench(cmd_tbl_t *cmdtp, int flag, int argc,
+			   char * const argv[])
+{
+	unsigned long src, src_len, dst, dst_len = 0;
+	unsigned long loops = 1, i;
+	unsigned long start, us;
+	int comp;
+
+	if (argc < 4)
+		return CMD_RET_USAGE;
+
+	src = simple_strtoul(argv[1], NULL, 16);
+	src_len = simple_strtoul(argv[2], NULL, 16);
+	dst = simple_strtoul(argv[3], NULL, 16);
+	if (argc > 4)
+		loops = simple_strtoul(argv[4], NULL, 10);
+	if (!loops)
+		loops = 1;
+
+	comp = unzip_get_comp((void *)src);
+	if (comp == IH_COMP_NONE) {
+		puts("Unknown compression format\n");
+		return CMD_RET_FAILURE;
+	}
+
+	start = timer_get_us();
+	for (i = 0; i < loops; i++) {
+		dst_len = CONFIG_SYS_BOOTM_LEN;
+		if (unzip_comp(comp, (void *)dst, &dst_len, (void *)src,
+			       src_len) != 0) {
+			printf("%s: uncompress error\n",
+			       genimg_get_comp_name(comp));
+			return CMD_RET_FAILURE;
+		}
+	}
+	us = (timer_get_us() - start) / loops;
+	if (!us)
+		us = 1;
+
+	printf("%-6s in 0x%lx out 0x%lx: %lu us, %lu MB/s out, %lu MB/s in\n",
+	       genimg_get_comp_name(comp), src_len, dst_len, us,
+	       dst_len / us, src_len / us);
+	setenv_hex("filesize", dst_len);
+
+	return 0;
+}
+
+U_BOOT_CMD(
+	decompbench,	5,	1,	do_decomp_bench,
+	"measure decompression speed of a memory region",
+	"srcaddr srcsize dstaddr [loops]\n"
+	"    - format (gzip/bzip2/lzma/lzo/lz4) is detected from the magic"
+);
+#endif /* CONFIG_CMD_DECOMP_BENCH */
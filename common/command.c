@@ -13,6 +13,9 @@
 #include <command.h>
 #include <linux/ctype.h>
 #include <asm/arch/timer.h>
+#ifdef CONFIG_AML_DISPLAY_ASYNC
+#include <amlogic/display_async.h>
+#endif
 
 /*
  * Use puts() instead of printf() to avoid printf buffer overflow
@@ -536,6 +539,10 @@ enum command_ret_t cmd_process(int flag, int argc, char * const argv[],
 
 	/* If OK so far, then do the command */
 	if (!rc) {
+#ifdef CONFIG_AML_DISPLAY_ASYNC
+		/* step the display bring-up in between commands */
+		display_async_poll();
+#endif
 		if (ticks)
 			*ticks = get_timer(0);
 		rc = cmd_call(cmdtp, flag, argc, argv);
@@ -0,0 +1,262 @@
+/*
+ * Append only log of environment changes.
+ *
+ * The saved environment (the base) is followed by a log area: a header
+ * block tying the log to the base it applies on, then records of
+ * "name=value" / "name=" (delete) entries, each starting on a new write
+ * unit. saveenv appends one record with the differences to what is
+ * already stored, and only rewrites the base (compaction) when the log
+ * is full or does not match the base.
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <environment.h>
+#include <env_log.h>
+#include <errno.h>
+#include <malloc.h>
+#include <search.h>
+
+#if defined(CONFIG_ENV_AES) || defined(CONFIG_SYS_REDUNDAND_ENVIRONMENT)
+#error CONFIG_ENV_LOG does not support CONFIG_ENV_AES or a redundant environment
+#endif
+
+#define ENV_LOG_MAGIC		0x4c564e45	/* "ENVL" */
+#define ENV_LOG_REC_MAGIC	0x52564e45	/* "ENVR" */
+
+struct env_log_hdr {
+	uint32_t	magic;
+	uint32_t	gen;		/* bumped on every compaction */
+	uint32_t	base_crc;	/* crc of the base the log applies on */
+	uint32_t	crc;		/* over the fields above */
+};
+
+struct env_log_rec {
+	uint32_t	magic;
+	uint32_t	gen;
+	uint32_t	seq;		/* 0, 1, 2... within a generation */
+	uint32_t	len;		/* bytes of entries following */
+	uint32_t	crc;		/* over the fields above and entries */
+};
+
+/* export of what base + log hold, the reference for the next record */
+static char *env_log_shadow;
+static uint32_t env_log_gen;
+static uint32_t env_log_seq;
+static ulong env_log_end;
+static int env_log_ready;
+
+static uint32_t env_log_rec_crc(const struct env_log_rec *rec)
+{
+	uint32_t crc;
+
+	crc = crc32(0, (const uchar *)rec, offsetof(struct env_log_rec, crc));
+	return crc32(crc, (const uchar *)(rec + 1), rec->len);
+}
+
+static int env_log_snapshot(void)
+{
+	char *res;
+
+	if (!env_log_shadow) {
+		env_log_shadow = malloc(ENV_SIZE);
+		if (!env_log_shadow)
+			return -ENOMEM;
+	}
+	res = env_log_shadow;
+	if (hexport_r(&env_htab, '\0', 0, &res, ENV_SIZE, 0, NULL) < 0)
+		return -EINVAL;
+	return 0;
+}
+
+/* compare the names of two "name=value" entries, as hexport sorts them */
+static int env_log_keycmp(const char *a, const char *b)
+{
+	while (*a && *a != '=' && *a == *b) {
+		a++;
+		b++;
+	}
+	return (*a == '=' ? 0 : *a) - (*b == '=' ? 0 : *b);
+}
+
+/*
+ * Entries turning the sorted export @old into @new, written to @out.
+ * Returns their length, -1 if more than @size.
+ */
+static long env_log_diff(const char *old, const char *new,
+	char *out, ulong size)
+{
+	ulong len = 0, n;
+	int cmp;
+
+	while (*old || *new) {
+		if (!*old)
+			cmp = 1;
+		else if (!*new)
+			cmp = -1;
+		else
+			cmp = env_log_keycmp(old, new);
+
+		if (cmp < 0) {
+			/* gone, "name=" deletes it on import */
+			n = strchr(old, '=') - old + 1;
+			if (len + n + 1 > size)
+				return -1;
+			memcpy(out + len, old, n);
+			len += n;
+			out[len++] = '\0';
+			old += strlen(old) + 1;
+			continue;
+		}
+		if (cmp > 0 || strcmp(old, new)) {
+			n = strlen(new) + 1;
+			if (len + n > size)
+				return -1;
+			memcpy(out + len, new, n);
+			len += n;
+		}
+		if (!cmp)
+			old += strlen(old) + 1;
+		new += strlen(new) + 1;
+	}
+
+	return len;
+}
+
+int env_log_replay(const struct env_log_ops *ops, const env_t *base)
+{
+	struct env_log_hdr *hdr;
+	struct env_log_rec *rec;
+	char *buf;
+	ulong off;
+	int n = 0;
+
+	env_log_ready = 0;
+	buf = memalign(ARCH_DMA_MINALIGN, ops->size);
+	if (!buf)
+		return 0;
+	if (ops->read(0, ops->size, buf)) {
+		puts("env log: read failed\n");
+		goto out;
+	}
+
+	/* no log yet, or a base saved without one: next saveenv starts it */
+	hdr = (struct env_log_hdr *)buf;
+	if (hdr->magic != ENV_LOG_MAGIC || hdr->crc != crc32(0,
+		(uchar *)hdr, offsetof(struct env_log_hdr, crc)))
+		goto out;
+	env_log_gen = hdr->gen;
+	if (hdr->base_crc != base->crc) {
+		/* base rewritten without the log, e.g. by fw_setenv */
+		puts("env log: saved environment changed, log dropped\n");
+		goto out;
+	}
+
+	env_log_seq = 0;
+	for (off = ops->blksz; off + sizeof(*rec) <= ops->size;) {
+		rec = (struct env_log_rec *)(buf + off);
+		if (rec->magic != ENV_LOG_REC_MAGIC ||
+		    rec->gen != env_log_gen || rec->seq != env_log_seq ||
+		    rec->len > ops->size - off - sizeof(*rec) ||
+		    rec->crc != env_log_rec_crc(rec))
+			break;
+		if (!himport_r(&env_htab, (char *)(rec + 1), rec->len, '\0',
+				H_NOCLEAR, 0, 0, NULL)) {
+			error("env log: record %u import failed\n", rec->seq);
+			break;
+		}
+		n++;
+		env_log_seq++;
+		off += ALIGN(sizeof(*rec) + rec->len, ops->blksz);
+	}
+	env_log_end = off;
+	env_log_ready = !env_log_snapshot();
+	debug("env log: gen %u, %d records, %lu bytes\n",
+		env_log_gen, n, env_log_end);
+out:
+	free(buf);
+	return n;
+}
+
+int env_log_save(const struct env_log_ops *ops)
+{
+	struct env_log_rec *rec = NULL;
+	char *res = NULL;
+	ulong avail, size;
+	long len;
+	int ret = 1;
+
+	if (!env_log_ready || env_log_end + ops->blksz > ops->size)
+		return 1;
+
+	avail = ops->size - env_log_end;
+	res = malloc(ENV_SIZE);
+	rec = memalign(ARCH_DMA_MINALIGN, avail);
+	if (!res || !rec)
+		goto out;
+	if (hexport_r(&env_htab, '\0', 0, &res, ENV_SIZE, 0, NULL) < 0)
+		goto out;
+
+	len = env_log_diff(env_log_shadow, res, (char *)(rec + 1),
+		avail - sizeof(*rec));
+	if (len < 0)
+		goto out;
+	if (!len) {
+		ret = 0;
+		goto out;
+	}
+
+	rec->magic = ENV_LOG_REC_MAGIC;
+	rec->gen = env_log_gen;
+	rec->seq = env_log_seq;
+	rec->len = len;
+	rec->crc = env_log_rec_crc(rec);
+	size = ALIGN(sizeof(*rec) + len, ops->blksz);
+	memset((char *)(rec + 1) + len, 0, size - sizeof(*rec) - len);
+	if (ops->write(env_log_end, size, rec)) {
+		puts("env log: write failed\n");
+		env_log_ready = 0;
+		goto out;
+	}
+
+	env_log_end += size;
+	env_log_seq++;
+	free(env_log_shadow);
+	env_log_shadow = res;
+	res = NULL;
+	ret = 0;
+out:
+	free(rec);
+	free(res);
+	return ret;
+}
+
+int env_log_reset(const struct env_log_ops *ops, const env_t *base)
+{
+	struct env_log_hdr *hdr;
+	int ret;
+
+	env_log_ready = 0;
+	/* the header, and an empty first record to end the old ones */
+	hdr = memalign(ARCH_DMA_MINALIGN, 2 * ops->blksz);
+	if (!hdr)
+		return -ENOMEM;
+	memset(hdr, 0, 2 * ops->blksz);
+	hdr->magic = ENV_LOG_MAGIC;
+	hdr->gen = ++env_log_gen;
+	hdr->base_crc = base->crc;
+	hdr->crc = crc32(0, (uchar *)hdr, offsetof(struct env_log_hdr, crc));
+	ret = ops->write(0, 2 * ops->blksz, hdr);
+	free(hdr);
+	if (ret) {
+		puts("env log: write failed\n");
+		return ret;
+	}
+
+	env_log_seq = 0;
+	env_log_end = ops->blksz;
+	ret = env_log_snapshot();
+	env_log_ready = !ret;
+	return ret;
+}
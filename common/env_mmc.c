@@ -15,6 +15,9 @@
 #include <mmc.h>
 #include <search.h>
 #include <errno.h>
+#ifdef CONFIG_ENV_LOG
+#include <env_log.h>
+#endif
 
 #ifdef CONFIG_STORE_COMPATIBLE
 	#include <emmc_partitions.h>
@@ -26,6 +29,11 @@
 #error CONFIG_ENV_SIZE_REDUND should be the same as CONFIG_ENV_SIZE
 #endif
 
+#if defined(CONFIG_ENV_LOG) && \
+	(defined(CONFIG_ENV_OFFSET_REDUND) || !defined(CONFIG_CMD_SAVEENV))
+#error CONFIG_ENV_LOG needs CONFIG_CMD_SAVEENV, without CONFIG_ENV_OFFSET_REDUND
+#endif
+
 #ifndef CONFIG_STORE_COMPATIBLE
 char *env_name_spec = "MMC";
 #ifdef ENV_IS_EMBEDDED
@@ -155,7 +163,51 @@ static inline int write_env(struct mmc *mmc, unsigned long size,
 
 	return (n == blk_cnt) ? 0 : -1;
 }
+#endif /* CONFIG_CMD_SAVEENV */
+
+#ifdef CONFIG_ENV_LOG
+static inline int read_env(struct mmc *mmc, unsigned long size,
+			   unsigned long offset, const void *buffer);
+
+/* the log lives right behind the environment, in the same area */
+static struct mmc *env_log_mmc;
+static u32 env_log_offset;
+
+static int mmc_env_log_read(ulong offset, ulong size, void *buf)
+{
+	return read_env(env_log_mmc, size, env_log_offset + offset, buf);
+}
+
+static int mmc_env_log_write(ulong offset, ulong size, const void *buf)
+{
+	return write_env(env_log_mmc, size, env_log_offset + offset, buf);
+}
+
+static struct env_log_ops mmc_env_log = {
+	.size	= CONFIG_ENV_LOG_SIZE,
+	.read	= mmc_env_log_read,
+	.write	= mmc_env_log_write,
+};
+
+static int mmc_env_log_setup(struct mmc *mmc, u32 offset)
+{
+#ifdef CONFIG_STORE_COMPATIBLE
+	struct partitions *part_info;
+
+	part_info = find_mmc_partition_by_name(MMC_ENV_NAME);
+	if (!part_info ||
+	    part_info->size < CONFIG_ENV_SIZE + CONFIG_ENV_LOG_SIZE)
+		return -1;
+#endif
+	env_log_mmc = mmc;
+	env_log_offset = offset + CONFIG_ENV_SIZE;
+	mmc_env_log.blksz = mmc->write_bl_len;
+
+	return 0;
+}
+#endif /* CONFIG_ENV_LOG */
 
+#ifdef CONFIG_CMD_SAVEENV
 #ifdef CONFIG_ENV_OFFSET_REDUND
 static unsigned char env_flags;
 #endif
@@ -174,6 +226,18 @@ int saveenv(void)
 	if (init_mmc_for_env(mmc))
 		return 1;
 
+#ifdef CONFIG_ENV_LOG
+	if (mmc_get_env_addr(mmc, 0, &offset)) {
+		ret = 1;
+		goto fini;
+	}
+	if (!mmc_env_log_setup(mmc, offset) && !env_log_save(&mmc_env_log)) {
+		printf("Appended to MMC(%d) env log\n", CONFIG_SYS_MMC_ENV_DEV);
+		ret = 0;
+		goto fini;
+	}
+#endif
+
 	ret = env_export(env_new);
 	if (ret)
 		goto fini;
@@ -201,6 +265,12 @@ int saveenv(void)
 	puts("done\n");
 	ret = 0;
 
+#ifdef CONFIG_ENV_LOG
+	/* compacted: whatever the log held is in the new base */
+	if (!mmc_env_log_setup(mmc, offset))
+		env_log_reset(&mmc_env_log, env_new);
+#endif
+
 #ifdef CONFIG_ENV_OFFSET_REDUND
 	gd->env_valid = gd->env_valid == 2 ? 1 : 2;
 #endif
@@ -355,7 +425,12 @@ void env_relocate_spec(void)
 		goto fini;
 	}
 
+#ifdef CONFIG_ENV_LOG
+	if (env_import(buf, 1) && !mmc_env_log_setup(mmc, offset))
+		env_log_replay(&mmc_env_log, (env_t *)buf);
+#else
 	env_import(buf, 1);
+#endif
 	ret = 0;
 
 fini:
@@ -6,6 +6,7 @@
 
 #include <config.h>
 #include <common.h>
+#include <errno.h>
 #include <fb_mmc.h>
 #include <part.h>
 #include <aboot.h>
@@ -323,3 +324,130 @@ void fb_mmc_erase_write(const char *cmd, void *download_buffer)
 
 	}
 }
+
+#ifdef CONFIG_FASTBOOT_FLASH_STREAM
+/* partition written while the image is still being downloaded */
+static struct {
+	block_dev_desc_t	*dev_desc;
+	disk_partition_t	info;
+	char			part_name[32];
+	int			is_sparse;	/* -1 until the image head is received */
+	lbaint_t		blk;		/* next block of raw image */
+	struct fb_mmc_sparse	sparse_priv;
+	struct sparse_storage	sparse;
+	struct sparse_stream	sparse_st;
+} fb_mmc_stream;
+
+int fb_mmc_stream_start(const char *cmd, uint64_t *part_bytes)
+{
+	block_dev_desc_t *dev_desc;
+	int ret = -ENODEV;
+
+	dev_desc = get_dev("mmc", CONFIG_FASTBOOT_FLASH_MMC_DEV);
+	if (!dev_desc || dev_desc->type == DEV_TYPE_UNKNOWN) {
+		error("invalid mmc device");
+		return -ENODEV;
+	}
+	/* images that are post-processed as a whole can't be streamed */
+	if (!strcmp(cmd, "dtb") || !strcmp(cmd, CONFIG_FASTBOOT_MBR_NAME) ||
+	    !strcmp(cmd, CONFIG_FASTBOOT_GPT_NAME) ||
+	    !strncmp(cmd, "bootloader", strlen("bootloader")))
+		return -EINVAL;
+
+#ifdef CONFIG_EFI_PARTITION
+	if (dev_desc->part_type == PART_TYPE_EFI)
+		ret = part_get_info_efi_by_name_or_alias(dev_desc, cmd,
+				&fb_mmc_stream.info);
+#endif
+#ifdef CONFIG_AML_PARTITION
+	if ((dev_desc->part_type == PART_TYPE_AML)
+		|| (dev_desc->part_type == PART_TYPE_DOS))
+		ret = get_partition_info_aml_by_name(dev_desc, cmd,
+				&fb_mmc_stream.info);
+#endif
+	if (ret) {
+		error("cannot find partition: '%s'", cmd);
+		return -ENODEV;
+	}
+
+	fb_mmc_stream.dev_desc = dev_desc;
+	strncpy(fb_mmc_stream.part_name, cmd, sizeof(fb_mmc_stream.part_name) - 1);
+	fb_mmc_stream.part_name[sizeof(fb_mmc_stream.part_name) - 1] = 0;
+	fb_mmc_stream.is_sparse = -1;
+	fb_mmc_stream.blk = fb_mmc_stream.info.start;
+	*part_bytes = (uint64_t)fb_mmc_stream.info.size * fb_mmc_stream.info.blksz;
+
+	return 0;
+}
+
+int fb_mmc_stream_write(void *buffer, unsigned int bytes, int is_last,
+			unsigned int *used)
+{
+	disk_partition_t *info = &fb_mmc_stream.info;
+	lbaint_t blkcnt, blks;
+
+	*used = 0;
+	if (fb_mmc_stream.is_sparse < 0) {
+		if (bytes < sizeof(sparse_header_t) && !is_last)
+			return 0;
+		fb_mmc_stream.is_sparse = bytes >= sizeof(sparse_header_t) &&
+					  is_sparse_image(buffer);
+		if (fb_mmc_stream.is_sparse) {
+			fb_mmc_stream.sparse_priv.dev_desc = fb_mmc_stream.dev_desc;
+			fb_mmc_stream.sparse.blksz = info->blksz;
+			fb_mmc_stream.sparse.start = info->start;
+			fb_mmc_stream.sparse.size = info->size;
+			fb_mmc_stream.sparse.write = fb_mmc_sparse_write;
+			fb_mmc_stream.sparse.reserve = fb_mmc_sparse_reserve;
+			fb_mmc_stream.sparse.priv = &fb_mmc_stream.sparse_priv;
+			write_sparse_stream_init(&fb_mmc_stream.sparse,
+						 &fb_mmc_stream.sparse_st);
+			printf("Flashing sparse image at offset " LBAFU "\n",
+			       info->start);
+		} else {
+			puts("Flashing Raw Image\n");
+		}
+	}
+
+	if (fb_mmc_stream.is_sparse)
+		return write_sparse_image_stream(&fb_mmc_stream.sparse,
+				&fb_mmc_stream.sparse_st, buffer, bytes, used);
+
+	/* raw image: whole blocks, the last partial block is padded */
+	blkcnt = bytes / info->blksz;
+	if (is_last)
+		blkcnt = DIV_ROUND_UP(bytes, info->blksz);
+	if (!blkcnt)
+		return 0;
+	if (fb_mmc_stream.blk + blkcnt > info->start + info->size) {
+		error("too large for partition: '%s'\n", fb_mmc_stream.part_name);
+		fastboot_fail("too large for partition");
+		return -1;
+	}
+	blks = fb_mmc_stream.dev_desc->block_write(fb_mmc_stream.dev_desc->dev,
+			fb_mmc_stream.blk, blkcnt, buffer);
+	if (blks != blkcnt) {
+		error("failed writing to device %d\n", fb_mmc_stream.dev_desc->dev);
+		fastboot_fail("failed writing to device");
+		return -1;
+	}
+	fb_mmc_stream.blk += blkcnt;
+	*used = min_t(unsigned int, bytes, blkcnt * info->blksz);
+
+	return 0;
+}
+
+void fb_mmc_stream_end(void)
+{
+	if (fb_mmc_stream.is_sparse > 0) {
+		write_sparse_stream_end(&fb_mmc_stream.sparse_st,
+					fb_mmc_stream.part_name);
+		return;
+	}
+
+	printf("........ wrote " LBAFU " bytes to '%s'\n",
+	       (fb_mmc_stream.blk - fb_mmc_stream.info.start) *
+	       fb_mmc_stream.info.blksz, fb_mmc_stream.part_name);
+	fastboot_okay("");
+}
+#endif /* CONFIG_FASTBOOT_FLASH_STREAM */
@@ -0,0 +1,446 @@
+/*
+ * Batched device tree property edits.
+ *
+ * Every fdt_setprop() that grows a property or adds a node moves the
+ * rest of the blob, and every fdt_path_offset() scans it again. Between
+ * fdt_batch_begin() and fdt_batch_commit() the edits of
+ * fdt_batch_setprop() are only recorded, by path. The commit resolves
+ * each path once and rewrites the structure block in a single pass,
+ * with the new properties and nodes in place.
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <malloc.h>
+#include <fdt_support.h>
+
+#define FDT_BATCH_MAX_DEPTH	32
+
+struct fdt_batch_prop {
+	struct fdt_batch_prop	*next;
+	const char		*name;
+	const void		*val;
+	int			len;
+	int			nameoff;	/* in the committed blob */
+	int			done;
+	/* name and value follow */
+};
+
+struct fdt_batch_node {
+	struct fdt_batch_node	*next;		/* all nodes of the batch */
+	struct fdt_batch_node	*parent;
+	struct fdt_batch_prop	*props;
+	int			offset;		/* < 0 if to be created */
+	int			resolved;
+	int			flushed;	/* new props and nodes written */
+	char			path[];
+};
+
+static struct {
+	void			*blob;
+	struct fdt_batch_node	*nodes;
+} fdt_batch;
+
+/* output of a commit: the new structure block and the added strings */
+struct fdt_batch_out {
+	char	*buf;
+	int	len;
+	char	*strings;
+	int	strings_len;
+	int	old_strings_len;
+};
+
+static void fdt_batch_free(void)
+{
+	struct fdt_batch_node *node, *next_node;
+	struct fdt_batch_prop *prop, *next_prop;
+
+	for (node = fdt_batch.nodes; node; node = next_node) {
+		next_node = node->next;
+		for (prop = node->props; prop; prop = next_prop) {
+			next_prop = prop->next;
+			free(prop);
+		}
+		free(node);
+	}
+	fdt_batch.nodes = NULL;
+	fdt_batch.blob = NULL;
+}
+
+static struct fdt_batch_node *fdt_batch_get_node(const char *path, int len)
+{
+	struct fdt_batch_node *node, **tail;
+
+	for (tail = &fdt_batch.nodes; *tail; tail = &(*tail)->next) {
+		node = *tail;
+		if (!strncmp(node->path, path, len) && !node->path[len])
+			return node;
+	}
+
+	node = calloc(1, sizeof(*node) + len + 1);
+	if (!node)
+		return NULL;
+	memcpy(node->path, path, len);
+	*tail = node;
+	return node;
+}
+
+/* offset of @path in @fdt, creating the missing nodes */
+static int fdt_batch_path_offset(void *fdt, const char *path)
+{
+	const char *end;
+	int node = 0, offset;
+
+	while (*path) {
+		while (*path == '/')
+			path++;
+		if (!*path)
+			break;
+		for (end = path; *end && *end != '/'; end++)
+			;
+		offset = fdt_subnode_offset_namelen(fdt, node, path,
+						    end - path);
+		if (offset == -FDT_ERR_NOTFOUND)
+			offset = fdt_add_subnode_namelen(fdt, node, path,
+							 end - path);
+		if (offset < 0)
+			return offset;
+		node = offset;
+		path = end;
+	}
+
+	return node;
+}
+
+int fdt_batch_begin(void *fdt)
+{
+	if (fdt_batch.blob)
+		return -FDT_ERR_BADSTATE;
+
+	fdt_batch.blob = fdt;
+	return 0;
+}
+
+int fdt_batch_setprop(void *fdt, const char *path, const char *name,
+		      const void *val, int len)
+{
+	struct fdt_batch_node *node;
+	struct fdt_batch_prop *prop, **tail;
+	int offset, len_path;
+
+	if (fdt != fdt_batch.blob) {
+		offset = fdt_batch_path_offset(fdt, path);
+		if (offset < 0)
+			return offset;
+		return fdt_setprop(fdt, offset, name, val, len);
+	}
+
+	if (path[0] != '/')
+		return -FDT_ERR_BADPATH;
+	len_path = strlen(path);
+	while (len_path > 1 && path[len_path - 1] == '/')
+		len_path--;
+	node = fdt_batch_get_node(path, len_path);
+	if (!node)
+		return -FDT_ERR_NOSPACE;
+
+	prop = malloc(sizeof(*prop) + strlen(name) + 1 + len);
+	if (!prop)
+		return -FDT_ERR_NOSPACE;
+	prop->next = NULL;
+	prop->name = (char *)(prop + 1);
+	strcpy((char *)prop->name, name);
+	prop->val = prop->name + strlen(name) + 1;
+	memcpy((void *)prop->val, val, len);
+	prop->len = len;
+	prop->done = 0;
+
+	/* a later edit of the same property wins */
+	for (tail = &node->props; *tail; tail = &(*tail)->next) {
+		if (!strcmp((*tail)->name, name)) {
+			prop->next = (*tail)->next;
+			free(*tail);
+			break;
+		}
+	}
+	*tail = prop;
+
+	return 0;
+}
+
+/* the path -> offset index: each node looked up once, below its parent */
+static int fdt_batch_resolve(const void *fdt, struct fdt_batch_node *node)
+{
+	const char *name;
+	int ret;
+
+	if (node->resolved)
+		return 0;
+	node->resolved = 1;
+
+	if (!node->path[1]) {
+		node->offset = 0;
+		return 0;
+	}
+
+	name = strrchr(node->path, '/');
+	node->parent = fdt_batch_get_node(node->path,
+		name == node->path ? 1 : name - node->path);
+	if (!node->parent)
+		return -FDT_ERR_NOSPACE;
+	ret = fdt_batch_resolve(fdt, node->parent);
+	if (ret < 0)
+		return ret;
+
+	name++;
+	if (node->parent->offset < 0)
+		node->offset = -FDT_ERR_NOTFOUND;
+	else
+		node->offset = fdt_subnode_offset(fdt, node->parent->offset,
+						  name);
+	if (node->offset < 0 && node->offset != -FDT_ERR_NOTFOUND)
+		return node->offset;
+
+	return 0;
+}
+
+static int fdt_batch_nameoff(const void *fdt, struct fdt_batch_out *out,
+			     const char *name)
+{
+	const char *strings = fdt + fdt_off_dt_strings(fdt);
+	int len = strlen(name) + 1;
+	int i;
+
+	for (i = 0; i + len <= out->old_strings_len;
+	     i += strlen(strings + i) + 1)
+		if (!memcmp(strings + i, name, len))
+			return i;
+	for (i = 0; i < out->strings_len; i += strlen(out->strings + i) + 1)
+		if (!strcmp(out->strings + i, name))
+			return out->old_strings_len + i;
+
+	memcpy(out->strings + out->strings_len, name, len);
+	out->strings_len += len;
+	return out->old_strings_len + out->strings_len - len;
+}
+
+static void fdt_batch_put32(struct fdt_batch_out *out, uint32_t val)
+{
+	*(fdt32_t *)(out->buf + out->len) = cpu_to_fdt32(val);
+	out->len += FDT_TAGSIZE;
+}
+
+static void fdt_batch_put(struct fdt_batch_out *out, const void *data, int len)
+{
+	memcpy(out->buf + out->len, data, len);
+	memset(out->buf + out->len + len, 0, ALIGN(len, FDT_TAGSIZE) - len);
+	out->len += ALIGN(len, FDT_TAGSIZE);
+}
+
+static void fdt_batch_put_prop(struct fdt_batch_out *out,
+			       struct fdt_batch_prop *prop)
+{
+	fdt_batch_put32(out, FDT_PROP);
+	fdt_batch_put32(out, prop->len);
+	fdt_batch_put32(out, prop->nameoff);
+	fdt_batch_put(out, prop->val, prop->len);
+	prop->done = 1;
+}
+
+static void fdt_batch_flush(struct fdt_batch_out *out,
+			    struct fdt_batch_node *node);
+
+/*
+ * New subnodes of @parent, last queued first: where and in which order
+ * fdt_add_subnode() one by one would have put them.
+ */
+static void fdt_batch_put_children(struct fdt_batch_out *out,
+				   struct fdt_batch_node *parent)
+{
+	struct fdt_batch_node *node, *last, *stop = NULL;
+	const char *name;
+
+	for (;;) {
+		last = NULL;
+		for (node = fdt_batch.nodes; node != stop; node = node->next)
+			if (node->parent == parent && node->offset < 0)
+				last = node;
+		if (!last)
+			break;
+		stop = last;
+
+		name = strrchr(last->path, '/') + 1;
+		fdt_batch_put32(out, FDT_BEGIN_NODE);
+		fdt_batch_put(out, name, strlen(name) + 1);
+		fdt_batch_flush(out, last);
+		fdt_batch_put32(out, FDT_END_NODE);
+	}
+}
+
+/* what @node gets that is not in the blob, ahead of its first subnode */
+static void fdt_batch_flush(struct fdt_batch_out *out,
+			    struct fdt_batch_node *node)
+{
+	struct fdt_batch_prop *prop;
+
+	if (!node || node->flushed)
+		return;
+	node->flushed = 1;
+	for (prop = node->props; prop; prop = prop->next)
+		if (!prop->done)
+			fdt_batch_put_prop(out, prop);
+	fdt_batch_put_children(out, node);
+}
+
+static struct fdt_batch_node *fdt_batch_find(int offset)
+{
+	struct fdt_batch_node *node;
+
+	for (node = fdt_batch.nodes; node; node = node->next)
+		if (node->offset == offset)
+			return node;
+	return NULL;
+}
+
+static int fdt_batch_rewrite(const void *fdt, struct fdt_batch_out *out)
+{
+	struct fdt_batch_node *stack[FDT_BATCH_MAX_DEPTH];
+	struct fdt_batch_node *node;
+	struct fdt_batch_prop *prop;
+	const struct fdt_property *fprop;
+	const char *name;
+	uint32_t tag;
+	int offset = 0, next, depth = 0;
+
+	do {
+		tag = fdt_next_tag(fdt, offset, &next);
+		if (next < 0)
+			return -FDT_ERR_BADSTRUCTURE;
+		node = depth ? stack[depth - 1] : NULL;
+
+		switch (tag) {
+		case FDT_BEGIN_NODE:
+			fdt_batch_flush(out, node);
+			if (depth == FDT_BATCH_MAX_DEPTH)
+				return -FDT_ERR_BADSTRUCTURE;
+			stack[depth++] = fdt_batch_find(offset);
+			break;
+
+		case FDT_PROP:
+			if (!node)
+				break;
+			fprop = fdt_offset_ptr(fdt, offset, sizeof(*fprop));
+			name = fdt_string(fdt, fdt32_to_cpu(fprop->nameoff));
+			for (prop = node->props; prop; prop = prop->next)
+				if (!prop->done && !strcmp(prop->name, name))
+					break;
+			if (prop) {
+				fdt_batch_put_prop(out, prop);
+				offset = next;
+				continue;
+			}
+			break;
+
+		case FDT_END_NODE:
+			if (!depth)
+				return -FDT_ERR_BADSTRUCTURE;
+			fdt_batch_flush(out, node);
+			depth--;
+			break;
+
+		case FDT_NOP:
+			offset = next;
+			continue;
+		}
+
+		memcpy(out->buf + out->len, fdt + fdt_off_dt_struct(fdt) + offset,
+		       next - offset);
+		out->len += next - offset;
+		offset = next;
+	} while (tag != FDT_END);
+
+	return 0;
+}
+
+int fdt_batch_commit(void *fdt)
+{
+	struct fdt_batch_out out = { 0 };
+	struct fdt_batch_node *node;
+	struct fdt_batch_prop *prop;
+	int size, strings_size, off_strings, ret;
+
+	if (fdt != fdt_batch.blob)
+		return fdt_batch.blob ? -FDT_ERR_BADSTATE : 0;
+	if (!fdt_batch.nodes) {
+		fdt_batch_free();
+		return 0;
+	}
+
+	ret = fdt_open_into(fdt, fdt, fdt_totalsize(fdt));
+	if (ret < 0)
+		goto out;
+
+	/* resolve the paths, and bound what the edits add */
+	out.old_strings_len = fdt_size_dt_strings(fdt);
+	size = fdt_size_dt_struct(fdt);
+	strings_size = 0;
+	for (node = fdt_batch.nodes; node; node = node->next) {
+		ret = fdt_batch_resolve(fdt, node);
+		if (ret < 0)
+			goto out;
+	}
+	for (node = fdt_batch.nodes; node; node = node->next) {
+		if (node->offset < 0)
+			size += 2 * FDT_TAGSIZE +
+				ALIGN(strlen(strrchr(node->path, '/')),
+				      FDT_TAGSIZE);
+		for (prop = node->props; prop; prop = prop->next) {
+			size += sizeof(struct fdt_property) +
+				ALIGN(prop->len, FDT_TAGSIZE);
+			strings_size += strlen(prop->name) + 1;
+		}
+	}
+
+	out.buf = malloc(size);
+	out.strings = malloc(strings_size);
+	if (!out.buf || !out.strings) {
+		ret = -FDT_ERR_NOSPACE;
+		goto out;
+	}
+	for (node = fdt_batch.nodes; node; node = node->next)
+		for (prop = node->props; prop; prop = prop->next)
+			prop->nameoff = fdt_batch_nameoff(fdt, &out, prop->name);
+
+	ret = fdt_batch_rewrite(fdt, &out);
+	if (ret < 0)
+		goto out;
+
+	off_strings = fdt_off_dt_struct(fdt) + out.len;
+	if (off_strings + out.old_strings_len + out.strings_len >
+	    fdt_totalsize(fdt)) {
+		ret = -FDT_ERR_NOSPACE;
+		goto out;
+	}
+
+	/* the only moves of the blob: strings behind the new structure */
+	memmove(fdt + off_strings, fdt + fdt_off_dt_strings(fdt),
+		out.old_strings_len);
+	memcpy(fdt + off_strings + out.old_strings_len, out.strings,
+	       out.strings_len);
+	memcpy(fdt + fdt_off_dt_struct(fdt), out.buf, out.len);
+	fdt_set_size_dt_struct(fdt, out.len);
+	fdt_set_off_dt_strings(fdt, off_strings);
+	fdt_set_size_dt_strings(fdt, out.old_strings_len + out.strings_len);
+	ret = 0;
+out:
+	free(out.buf);
+	free(out.strings);
+	fdt_batch_free();
+	return ret;
+}
+
+void fdt_batch_abort(void)
+{
+	fdt_batch_free();
+}
@@ -341,15 +341,10 @@ int fdt_chosen(void *fdt)
 		return err;
 	}
 
-	/* find or create "/chosen" node. */
-	nodeoffset = fdt_find_or_add_subnode(fdt, 0, "chosen");
-	if (nodeoffset < 0)
-		return nodeoffset;
-
 	str = getenv("bootargs");
 	if (str) {
-		err = fdt_setprop(fdt, nodeoffset, "bootargs", str,
-				  strlen(str) + 1);
+		/* creates "/chosen" if needed, deferred in a batch */
+		err = fdt_batch_setprop_string(fdt, "/chosen", "bootargs", str);
 		if (err < 0) {
 			printf("WARNING: could not set bootargs %s.\n",
 			       fdt_strerror(err));
@@ -357,6 +352,16 @@ int fdt_chosen(void *fdt)
 		}
 	}
 
+#if defined(OF_STDOUT_PATH) || \
+	(defined(CONFIG_OF_STDOUT_VIA_ALIAS) && defined(CONFIG_CONS_INDEX))
+	/* find or create "/chosen" node. */
+	nodeoffset = fdt_find_or_add_subnode(fdt, 0, "chosen");
+	if (nodeoffset < 0)
+		return nodeoffset;
+#else
+	nodeoffset = 0;		/* fdt_fixup_stdout() does nothing */
+#endif
+
 	return fdt_fixup_stdout(fdt, nodeoffset);
 }
 
@@ -492,20 +497,18 @@ int fdt_fixup_memory_banks(void *blob, u64 start[], u64 size[], int banks)
 		return err;
 	}
 
-	/* find or create "/memory" node. */
-	nodeoffset = fdt_find_or_add_subnode(blob, 0, "memory");
-	if (nodeoffset < 0)
-			return nodeoffset;
-
-	err = fdt_setprop(blob, nodeoffset, "device_type", "memory",
-			sizeof("memory"));
+	/* "/memory" is created if needed, deferred in a batch */
+	err = fdt_batch_setprop_string(blob, "/memory", "device_type",
+				       "memory");
 	if (err < 0) {
 		printf("WARNING: could not set %s %s.\n", "device_type",
 				fdt_strerror(err));
 		return err;
 	}
 
-	reg = fdt_getprop(blob, nodeoffset, "reg", NULL);
+	nodeoffset = fdt_path_offset(blob, "/memory");
+	reg = nodeoffset < 0 ? NULL :
+		fdt_getprop(blob, nodeoffset, "reg", NULL);
 	printf("%s, reg:%p\n", __func__, reg);
 	if (reg) {
 		printf("DTS already have 'reg' property\n");
@@ -514,7 +517,7 @@ int fdt_fixup_memory_banks(void *blob, u64 start[], u64 size[], int banks)
 
 	len = fdt_pack_reg(blob, tmp, start, size, banks);
 
-	err = fdt_setprop(blob, nodeoffset, "reg", tmp, len);
+	err = fdt_batch_setprop(blob, "/memory", "reg", tmp, len);
 	if (err < 0) {
 		printf("WARNING: could not set %s %s.\n",
 				"reg", fdt_strerror(err));
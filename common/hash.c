@@ -337,7 +337,9 @@ int hash_block(const char *algo_name, const void *data, unsigned int len,
 	}
 	if (output_size)
 		*output_size = algo->digest_size;
+	bootstage_start(BOOTSTAGE_ID_ACCUM_HASH, "hash");
 	algo->hash_func_ws(data, len, output, algo->chunk_size);
+	bootstage_accum_data(BOOTSTAGE_ID_ACCUM_HASH, len);
 
 	return 0;
 }
@@ -371,7 +373,9 @@ int hash_command(const char *algo_name, int flags, cmd_tbl_t *cmdtp, int flag,
 		}
 
 		buf = map_sysmem(addr, len);
+		bootstage_start(BOOTSTAGE_ID_ACCUM_HASH, "hash");
 		algo->hash_func_ws(buf, len, output, algo->chunk_size);
+		bootstage_accum_data(BOOTSTAGE_ID_ACCUM_HASH, len);
 		unmap_sysmem(buf);
 
 		/* Try to avoid code bloat when verify is not needed */
@@ -17,6 +17,15 @@ static const unsigned char gzip_magic[] = {
 	0x1f, 0x8b
 };
 
+/* lz4 frame format, and legacy format used by the kernel Image.lz4 */
+static const unsigned char lz4_magic[] = {
+	0x04, 0x22, 0x4d, 0x18
+};
+
+static const unsigned char lz4_legacy_magic[] = {
+	0x02, 0x21, 0x4c, 0x18
+};
+
 static char andr_tmp_str[ANDR_BOOT_ARGS_SIZE + 1];
 
 #ifdef CONFIG_OF_LIBFDT_OVERLAY
@@ -206,20 +215,87 @@ ulong android_image_get_comp(const struct andr_img_hdr *os_hdr)
 	if (i == ARRAY_SIZE(gzip_magic))
 		return IH_COMP_GZIP;
 
+	src = (unsigned char *)os_hdr + os_hdr->page_size;
+	if (!memcmp(src, lz4_magic, sizeof(lz4_magic)) ||
+	    !memcmp(src, lz4_legacy_magic, sizeof(lz4_legacy_magic)))
+		return IH_COMP_LZ4;
+
 	return IH_COMP_NONE;
 }
-int android_image_need_move(ulong *img_addr, const struct andr_img_hdr *hdr)
+/*
+ * Relocation buffer that 'imgread kernel' has already read the image into,
+ * so android_image_need_move() can hand it out without another copy.
+ */
+static ulong andr_preload_img_addr;
+static void *andr_preload_reloc_buf;
+
+/**
+ * android_image_reloc_required() - check if the image at @img_addr must be
+ *			moved before its kernel can be decompressed
+ * @img_addr:	Address the image is (to be) loaded at
+ * @hdr:	Pointer to image header
+ *
+ * A compressed kernel is decompressed to its load address, which would
+ * overwrite the ramdisk/second of an image loaded within 32MB of it.
+ *
+ * Return: 1 if the image must be moved away first, otherwise 0.
+ */
+int android_image_reloc_required(ulong img_addr, const struct andr_img_hdr *hdr)
 {
 	ulong kernel_load_addr = android_image_get_kload(hdr);
-	ulong img_start = *img_addr;
 	ulong val = 0;
-	if (kernel_load_addr > img_start)
-		val = kernel_load_addr - img_start;
-	else
-		val = img_start - kernel_load_addr;
+
 	if (android_image_get_comp(hdr) == IH_COMP_NONE)
 		return 0;
-	if (val < 32*1024*1024) {
+	if (kernel_load_addr > img_addr)
+		val = kernel_load_addr - img_addr;
+	else
+		val = img_addr - kernel_load_addr;
+
+	return val < 32*1024*1024;
+}
+
+/**
+ * android_image_alloc_reloc() - allocate the relocation buffer for an image
+ *			which is about to be read into memory
+ * @img_addr:	Address the image header is loaded at
+ * @hdr:	Pointer to image header
+ *
+ * The caller reads the image straight into the returned buffer, and
+ * android_image_need_move() then uses it as is instead of copying the
+ * image from @img_addr.
+ *
+ * Return: relocation buffer on success, otherwise NULL.
+ */
+void *android_image_alloc_reloc(ulong img_addr, const struct andr_img_hdr *hdr)
+{
+	ulong total_size = android_image_get_end(hdr) - (ulong)hdr;
+
+	free(andr_preload_reloc_buf);
+	andr_preload_reloc_buf = malloc(total_size);
+	if (!andr_preload_reloc_buf) {
+		puts("Error: malloc in android_image_alloc_reloc failed!\n");
+		andr_preload_img_addr = 0;
+		return NULL;
+	}
+	andr_preload_img_addr = img_addr;
+
+	return andr_preload_reloc_buf;
+}
+
+int android_image_need_move(ulong *img_addr, const struct andr_img_hdr *hdr)
+{
+	ulong img_start = *img_addr;
+
+	if (!android_image_reloc_required(img_start, hdr))
+		return 0;
+	if (andr_preload_reloc_buf && andr_preload_img_addr == img_start &&
+	    !memcmp(andr_preload_reloc_buf, hdr, sizeof(*hdr))) {
+		*img_addr = (ulong)andr_preload_reloc_buf;
+		printf("reloc_addr =%lx (preloaded)\n", *img_addr);
+		return 0;
+	}
+	{
 		ulong total_size = android_image_get_end(hdr)-(ulong)hdr;
 		void *reloc_addr = malloc(total_size);
 		if (!reloc_addr) {
@@ -496,6 +496,10 @@ int image_setup_libfdt(bootm_headers_t *images, void *blob,
 	int ret = -EPERM;
 	int fdt_ret;
 
+	/* the fdt_support.c and board fixups of the blob for the kernel */
+	bootstage_start(BOOTSTAGE_ID_ACCUM_FDT_FIXUP, "fdt_fixup");
+	/* queue the edits by path, they are applied in one pass below */
+	fdt_batch_begin(blob);
 	if (fdt_chosen(blob) < 0) {
 		printf("ERROR: /chosen node create failed\n");
 		goto err;
@@ -520,6 +524,11 @@ int image_setup_libfdt(bootm_headers_t *images, void *blob,
 		}
 	}
 	fdt_fixup_ethernet(blob);
+	fdt_ret = fdt_batch_commit(blob);
+	if (fdt_ret) {
+		printf("ERROR: fdt fixup failed: %s\n", fdt_strerror(fdt_ret));
+		goto err;
+	}
 
 	/* Delete the old LMB reservation */
 	lmb_free(lmb, (phys_addr_t)(u32)(uintptr_t)blob,
@@ -550,8 +559,11 @@ int image_setup_libfdt(bootm_headers_t *images, void *blob,
 		ft_board_setup_ex(blob, gd->bd);
 #endif
 
+	bootstage_accum_data(BOOTSTAGE_ID_ACCUM_FDT_FIXUP, of_size);
 	return 0;
 err:
+	fdt_batch_abort();
+	bootstage_accum(BOOTSTAGE_ID_ACCUM_FDT_FIXUP);
 	printf(" - must RESET the board to recover.\n\n");
 
 	return ret;
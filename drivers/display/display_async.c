@@ -0,0 +1,89 @@
+/*
+ * drivers/display/display_async.c
+ *
+ * Copyright (C) 2018 Amlogic, Inc. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+*/
+
+#include <common.h>
+#include <amlogic/display_async.h>
+
+static struct display_async_task *task_list;
+/* a step may end up in code that polls or syncs again */
+static int task_running;
+
+static int task_due(struct display_async_task *task)
+{
+	return (long)(get_timer(0) - task->wake) >= 0;
+}
+
+void display_async_start(struct display_async_task *task)
+{
+	struct display_async_task **p;
+
+	for (p = &task_list; *p; p = &(*p)->next) {
+		if (*p == task)
+			return;
+	}
+	task->start = get_timer(0);
+	task->wake = task->start;
+	task->next = NULL;
+	*p = task;
+
+	display_async_poll();
+}
+
+void display_async_poll(void)
+{
+	struct display_async_task **p, *task;
+	int delay;
+
+	if (task_running || !task_list)
+		return;
+
+	task_running = 1;
+	p = &task_list;
+	while ((task = *p) != NULL) {
+		delay = 0;
+		while (task_due(task)) {
+			delay = task->step(task);
+			if (delay == DISPLAY_ASYNC_DONE)
+				break;
+			task->wake = get_timer(0) + delay;
+		}
+		if (delay == DISPLAY_ASYNC_DONE) {
+			debug("display: %s done in %lu ms\n", task->name,
+			      get_timer(task->start));
+			*p = task->next;
+		} else {
+			p = &task->next;
+		}
+	}
+	task_running = 0;
+}
+
+void display_async_sync(void)
+{
+	if (task_running)
+		return;
+
+	while (task_list) {
+		display_async_poll();
+		udelay(100);
+	}
+}
+
+int display_async_pending(void)
+{
+	return task_list != NULL;
+}
@@ -23,6 +23,7 @@
 #endif
 #include <amlogic/keyunify.h>
 #include <amlogic/aml_lcd.h>
+#include <amlogic/display_async.h>
 #ifdef CONFIG_AML_LCD_EXTERN
 #include <amlogic/aml_lcd_extern.h>
 #endif
@@ -118,7 +119,20 @@ static int lcd_check_valid(void)
 	return 0;
 }
 
-static void lcd_power_ctrl(int status)
+/* position in a power sequence, see lcd_power_step() */
+struct lcd_power_seq_s {
+	int status;
+	unsigned int i;		/* step */
+	unsigned int wait;	/* ms waited on a wait_gpio step */
+};
+
+/*
+ * Run step seq->i of the power on or off sequence, return the ms to wait
+ * before the next step or DISPLAY_ASYNC_DONE after the last one. A
+ * wait_gpio step stays current, 1ms apart, until the gpio matches or
+ * its delay runs out.
+ */
+static int lcd_power_step(struct lcd_power_seq_s *seq)
 {
 	struct aml_lcd_drv_s *lcd_drv = aml_lcd_get_driver();
 	struct lcd_power_ctrl_s *lcd_power;
@@ -127,15 +141,19 @@ static void lcd_power_ctrl(int status)
 	struct aml_lcd_extern_driver_s *ext_drv;
 #endif
 	char *str;
-	unsigned int i, wait, gpio;
+	unsigned int gpio;
 	int value = LCD_PMU_GPIO_NUM_MAX;
+	int status = seq->status;
+
+	if (seq->i >= LCD_PWR_STEP_MAX)
+		return DISPLAY_ASYNC_DONE;
 
-	i = 0;
 	lcd_power = lcd_drv->lcd_config->lcd_power;
 	if (status) {
 		/* check if factory test */
 		if (lcd_drv->factory_lcd_power_on_step) {
-			LCDPR("%s: factory test power_on_step!\n", __func__);
+			if (seq->i == 0 && seq->wait == 0)
+				LCDPR("%s: factory test power_on_step!\n", __func__);
 			power_step = lcd_drv->factory_lcd_power_on_step;
 		} else {
 			power_step = &lcd_power->power_on_step[0];
@@ -143,98 +161,109 @@ static void lcd_power_ctrl(int status)
 	} else {
 		power_step = &lcd_power->power_off_step[0];
 	}
-
-	while (i < LCD_PWR_STEP_MAX) {
-		if (power_step->type >= LCD_POWER_TYPE_MAX)
-			break;
-		if (lcd_debug_print_flag) {
-			LCDPR("power_ctrl: %d, step %d: type=%d, index=%d, value=%d, delay=%d\n",
-				status, i, power_step->type, power_step->index,
-				power_step->value, power_step->delay);
+	power_step += seq->i;
+
+	if (power_step->type >= LCD_POWER_TYPE_MAX)
+		return DISPLAY_ASYNC_DONE;
+	if (lcd_debug_print_flag && seq->wait == 0) {
+		LCDPR("power_ctrl: %d, step %d: type=%d, index=%d, value=%d, delay=%d\n",
+			status, seq->i, power_step->type, power_step->index,
+			power_step->value, power_step->delay);
+	}
+	switch (power_step->type) {
+	case LCD_POWER_TYPE_CPU:
+		if (power_step->index < LCD_CPU_GPIO_NUM_MAX) {
+			str = lcd_power->cpu_gpio[power_step->index];
+			gpio = aml_lcd_gpio_name_map_num(str);
+			aml_lcd_gpio_set(gpio, power_step->value);
+		} else {
+			LCDERR("cpu_gpio index: %d\n", power_step->index);
 		}
-		switch (power_step->type) {
-		case LCD_POWER_TYPE_CPU:
-			if (power_step->index < LCD_CPU_GPIO_NUM_MAX) {
-				str = lcd_power->cpu_gpio[power_step->index];
-				gpio = aml_lcd_gpio_name_map_num(str);
-				aml_lcd_gpio_set(gpio, power_step->value);
-			} else {
-				LCDERR("cpu_gpio index: %d\n", power_step->index);
-			}
-			break;
-		case LCD_POWER_TYPE_PMU:
-			if (power_step->index < LCD_PMU_GPIO_NUM_MAX)
-				LCDPR("to do\n");
-			else
-				LCDERR("pmu_gpio index: %d\n", power_step->index);
-			break;
-		case LCD_POWER_TYPE_SIGNAL:
-			if (status)
-				lcd_drv->driver_init();
-			else
-				lcd_drv->driver_disable();
-			break;
+		break;
+	case LCD_POWER_TYPE_PMU:
+		if (power_step->index < LCD_PMU_GPIO_NUM_MAX)
+			LCDPR("to do\n");
+		else
+			LCDERR("pmu_gpio index: %d\n", power_step->index);
+		break;
+	case LCD_POWER_TYPE_SIGNAL:
+		if (status)
+			lcd_drv->driver_init();
+		else
+			lcd_drv->driver_disable();
+		break;
 #ifdef CONFIG_AML_LCD_EXTERN
-		case LCD_POWER_TYPE_EXTERN:
-			ext_drv = aml_lcd_extern_get_driver();
-			if (ext_drv) {
-				if (status) {
-					if (ext_drv->power_on)
-						ext_drv->power_on();
-					else
-						LCDERR("no ext power on\n");
-				} else {
-					if (ext_drv->power_off)
-						ext_drv->power_off();
-					else
-						LCDERR("no ext power off\n");
-				}
-			}
-			break;
-#endif
-		case LCD_POWER_TYPE_EXPANDER_IO:
-			if (power_step->index < LCD_EXPANDER_GPIO_NUM_MAX) {
-				aml_lcd_expander_gpio_set(power_step->index, power_step->value);
+	case LCD_POWER_TYPE_EXTERN:
+		ext_drv = aml_lcd_extern_get_driver();
+		if (ext_drv) {
+			if (status) {
+				if (ext_drv->power_on)
+					ext_drv->power_on();
+				else
+					LCDERR("no ext power on\n");
 			} else {
-				LCDERR("expander_gpio index: %d\n", power_step->index);
+				if (ext_drv->power_off)
+					ext_drv->power_off();
+				else
+					LCDERR("no ext power off\n");
 			}
+		}
+		break;
+#endif
+	case LCD_POWER_TYPE_EXPANDER_IO:
+		if (power_step->index < LCD_EXPANDER_GPIO_NUM_MAX) {
+			aml_lcd_expander_gpio_set(power_step->index, power_step->value);
+		} else {
+			LCDERR("expander_gpio index: %d\n", power_step->index);
+		}
+		break;
+	case LCD_POWER_TYPE_WAIT_GPIO:
+		if (power_step->index >= LCD_CPU_GPIO_NUM_MAX) {
+			LCDERR(
+			"wait_gpio index: %d\n", power_step->index);
 			break;
-		case LCD_POWER_TYPE_WAIT_GPIO:
-			if (power_step->index < LCD_CPU_GPIO_NUM_MAX) {
-				str = lcd_power->cpu_gpio[power_step->index];
-				gpio = aml_lcd_gpio_name_map_num(str);
-				aml_lcd_gpio_set(gpio, LCD_GPIO_INPUT);
-			} else {
-				LCDERR(
-				"wait_gpio index: %d\n", power_step->index);
-				break;
-			}
+		}
+		str = lcd_power->cpu_gpio[power_step->index];
+		gpio = aml_lcd_gpio_name_map_num(str);
+		if (seq->wait == 0) {
+			aml_lcd_gpio_set(gpio, LCD_GPIO_INPUT);
 			LCDPR("lcd_power_type_wait_gpio wait\n");
-			for (wait = 0; wait < power_step->delay; wait++) {
-				value = aml_lcd_gpio_input_get(gpio);
-				if (value == power_step->value) {
-					LCDPR(
-					"get value: %d, wait ok\n", value);
-					break;
-				}
-				mdelay(1);
+		}
+		if (seq->wait < power_step->delay) {
+			value = aml_lcd_gpio_input_get(gpio);
+			if (value != power_step->value) {
+				seq->wait++;
+				return 1;
 			}
-			if (wait == power_step->delay)
-				LCDERR(
-				"get value: %d, wait timeout!\n", value);
-			break;
-		case LCD_POWER_TYPE_CLK_SS:
-			break;
-		default:
-			break;
+			LCDPR(
+			"get value: %d, wait ok\n", value);
+		} else {
+			value = aml_lcd_gpio_input_get(gpio);
+			LCDERR(
+			"get value: %d, wait timeout!\n", value);
 		}
+		break;
+	case LCD_POWER_TYPE_CLK_SS:
+		break;
+	default:
+		break;
+	}
 
-		if (power_step->type != LCD_POWER_TYPE_WAIT_GPIO) {
-			if (power_step->delay > 0)
-				mdelay(power_step->delay);
-		}
-		i++;
-		power_step++;
+	seq->i++;
+	seq->wait = 0;
+	if (power_step->type != LCD_POWER_TYPE_WAIT_GPIO)
+		return power_step->delay;
+	return 0;
+}
+
+static void lcd_power_ctrl(int status)
+{
+	struct lcd_power_seq_s seq = {status, 0, 0};
+	int delay;
+
+	while ((delay = lcd_power_step(&seq)) != DISPLAY_ASYNC_DONE) {
+		if (delay > 0)
+			mdelay(delay);
 	}
 
 	if (lcd_debug_print_flag)
@@ -265,32 +294,78 @@ static void lcd_encl_on(void)
 	lcd_drv->lcd_status |= LCD_STATUS_ENCL_ON;
 }
 
-static void lcd_interface_on(void)
+/*
+ * Interface power on, with retries, and backlight enable, as a display
+ * task so the power sequence and backlight delays can overlap with
+ * loading when CONFIG_AML_DISPLAY_ASYNC is set.
+ */
+enum lcd_enable_state_e {
+	LCD_ENABLE_POWER_ON = 0,
+	LCD_ENABLE_RETRY_OFF,
+	LCD_ENABLE_RETRY_WAIT,
+	LCD_ENABLE_BL_DELAY,
+};
+
+static struct lcd_power_seq_s lcd_enable_seq;
+
+static int lcd_enable_step(struct display_async_task *task)
 {
 	struct aml_lcd_drv_s *lcd_drv = aml_lcd_get_driver();
 	struct lcd_config_s *pconf = lcd_drv->lcd_config;
-
-	lcd_power_ctrl(1);
-	pconf->retry_enable_cnt = 0;
-	while (pconf->retry_enable_flag) {
-		if (pconf->retry_enable_cnt++ >= LCD_ENABLE_RETRY_MAX)
-			break;
-		LCDPR("retry enable...%d\n", pconf->retry_enable_cnt);
-		lcd_power_ctrl(0);
-		mdelay(1000);
-		lcd_power_ctrl(1);
+	int delay;
+
+	switch (task->state) {
+	case LCD_ENABLE_POWER_ON:
+	case LCD_ENABLE_RETRY_OFF:
+		delay = lcd_power_step(&lcd_enable_seq);
+		if (delay != DISPLAY_ASYNC_DONE)
+			return delay;
+		if (task->state == LCD_ENABLE_RETRY_OFF) {
+			task->state = LCD_ENABLE_RETRY_WAIT;
+			return 1000;
+		}
+		if (pconf->retry_enable_flag &&
+		    (pconf->retry_enable_cnt++ < LCD_ENABLE_RETRY_MAX)) {
+			LCDPR("retry enable...%d\n", pconf->retry_enable_cnt);
+			memset(&lcd_enable_seq, 0, sizeof(lcd_enable_seq));
+			task->state = LCD_ENABLE_RETRY_OFF;
+			return 0;
+		}
+		pconf->retry_enable_cnt = 0;
+		lcd_drv->lcd_status |= LCD_STATUS_IF_ON;
+
+		aml_bl_pwm_config_update(lcd_drv->bl_config);
+		aml_bl_set_level(lcd_drv->bl_config->level_default);
+		task->state = LCD_ENABLE_BL_DELAY;
+		return aml_bl_power_on_delay();
+	case LCD_ENABLE_RETRY_WAIT:
+		memset(&lcd_enable_seq, 0, sizeof(lcd_enable_seq));
+		lcd_enable_seq.status = 1;
+		task->state = LCD_ENABLE_POWER_ON;
+		return 0;
+	case LCD_ENABLE_BL_DELAY:
+	default:
+		aml_bl_power_ctrl(1, 0);
+		if (!lcd_debug_test)
+			aml_lcd_mute_setting(0);
+		return DISPLAY_ASYNC_DONE;
 	}
-	pconf->retry_enable_cnt = 0;
-	lcd_drv->lcd_status |= LCD_STATUS_IF_ON;
 }
 
-static void lcd_backlight_enable(void)
+static struct display_async_task lcd_enable_task = {
+	.name = "lcd enable",
+	.step = lcd_enable_step,
+};
+
+static void lcd_interface_on(void)
 {
 	struct aml_lcd_drv_s *lcd_drv = aml_lcd_get_driver();
 
-	aml_bl_pwm_config_update(lcd_drv->bl_config);
-	aml_bl_set_level(lcd_drv->bl_config->level_default);
-	aml_bl_power_ctrl(1, 1);
+	memset(&lcd_enable_seq, 0, sizeof(lcd_enable_seq));
+	lcd_enable_seq.status = 1;
+	lcd_drv->lcd_config->retry_enable_cnt = 0;
+	lcd_enable_task.state = LCD_ENABLE_POWER_ON;
+	display_async_start(&lcd_enable_task);
 }
 
 static void lcd_module_enable(char *mode)
@@ -318,11 +393,11 @@ static void lcd_module_enable(char *mode)
 		lcd_encl_on();
 	if ((lcd_drv->lcd_status & LCD_STATUS_IF_ON) == 0) {
 		if (!boot_ctrl.lcd_init_level) {
+			/* unmuted once the backlight is on */
 			lcd_interface_on();
-			lcd_backlight_enable();
-		} else {
-			lcd_tcon_data_load(&ret_vac, &ret_demura);
+			return;
 		}
+		lcd_tcon_data_load(&ret_vac, &ret_demura);
 	}
 	if (!lcd_debug_test)
 		aml_lcd_mute_setting(0);
@@ -925,6 +1000,7 @@ static int lcd_outputmode_check(char *mode)
 
 static void lcd_prepare(char *mode)
 {
+	display_async_sync();
 	if (lcd_check_valid())
 		return;
 	if (aml_lcd_driver.lcd_status & LCD_STATUS_ENCL_ON)
@@ -935,6 +1011,7 @@ static void lcd_prepare(char *mode)
 
 static void lcd_enable(char *mode)
 {
+	display_async_sync();
 	if (lcd_check_valid())
 		return;
 	if (aml_lcd_driver.lcd_status & LCD_STATUS_IF_ON)
@@ -945,6 +1022,7 @@ static void lcd_enable(char *mode)
 
 static void lcd_disable(void)
 {
+	display_async_sync();
 	if (lcd_check_valid())
 		return;
 	if (aml_lcd_driver.lcd_status & LCD_STATUS_ENCL_ON)
@@ -792,6 +792,19 @@ static void bl_power_en_ctrl(struct bl_config_s *bconf, int status)
 	}
 }
 
+/* the wait of aml_bl_power_ctrl(1, 1) before powering on, in ms */
+int aml_bl_power_on_delay(void)
+{
+	struct aml_lcd_drv_s *lcd_drv = aml_lcd_get_driver();
+	struct bl_config_s *bconf = lcd_drv->bl_config;
+
+	if ((bconf == NULL) || (bl_off_policy != BL_OFF_POLICY_NONE))
+		return 0;
+	if (lcd_drv->factory_bl_power_on_delay >= 0)
+		return lcd_drv->factory_bl_power_on_delay;
+	return bconf->power_on_delay;
+}
+
 void aml_bl_power_ctrl(int status, int delay_flag)
 {
 	int gpio, value;
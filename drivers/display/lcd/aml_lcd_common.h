@@ -102,6 +102,7 @@ extern void aml_bl_pwm_config_update(struct bl_config_s *bconf);
 extern void aml_bl_set_level(unsigned int level);
 extern unsigned int aml_bl_get_level(void);
 extern void aml_bl_power_ctrl(int status, int delay_flag);
+extern int aml_bl_power_on_delay(void);
 extern int aml_bl_config_load(char *dt_addr, int load_id);
 #ifdef CONFIG_AML_LOCAL_DIMMING
 extern int ldim_config_load_from_dts(char *dt_addr, int child_offset);
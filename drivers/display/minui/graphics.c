@@ -35,6 +35,10 @@ static unsigned char gr_current_a = 255;
 
 extern GRSurface* gr_draw;
 
+// area drawn into gr_draw since the last flip
+static GRRect gr_dirty;
+static ulong gr_last_flip;
+
 void ui_set_log_level(int level)
 {
 	ui_log_level = level;
@@ -61,39 +65,105 @@ void gr_font_size(const GRFont* font, int *x, int *y)
 	*y = font->char_height;
 }
 
+static void gr_mark_dirty(int x1, int y1, int x2, int y2)
+{
+	if (x1 >= x2 || y1 >= y2)
+		return;
+
+	if (gr_dirty.x1 >= gr_dirty.x2) {
+		gr_dirty.x1 = x1;
+		gr_dirty.y1 = y1;
+		gr_dirty.x2 = x2;
+		gr_dirty.y2 = y2;
+		return;
+	}
+	if (x1 < gr_dirty.x1)
+		gr_dirty.x1 = x1;
+	if (y1 < gr_dirty.y1)
+		gr_dirty.y1 = y1;
+	if (x2 > gr_dirty.x2)
+		gr_dirty.x2 = x2;
+	if (y2 > gr_dirty.y2)
+		gr_dirty.y2 = y2;
+}
+
+// the current color as the bytes of a pixel
+static unsigned int gr_current_color(void)
+{
+	return gr_current_r | (gr_current_g << 8) | (gr_current_b << 16) |
+		((unsigned int)gr_current_a << 24);
+}
+
+#ifndef CONFIG_ARM64
+// t / 255 rounded down, exact for t up to 255 * 255
+static unsigned char div255(unsigned int t)
+{
+	return (t + 1 + (t >> 8)) >> 8;
+}
+
+void gr_row_fill(unsigned char* dst, int n, unsigned int color)
+{
+	for (; n > 0; --n) {
+		*dst++ = color;
+		*dst++ = color >> 8;
+		*dst++ = color >> 16;
+		*dst++ = color >> 24;
+	}
+}
+
+void gr_row_blend(unsigned char* dst, int n, unsigned int color)
+{
+	unsigned int a = color >> 24;
+	int i;
+
+	for (; n > 0; --n) {
+		for (i = 0; i < 3; ++i)
+			dst[i] = div255(dst[i] * (255-a) + ((color >> (8*i)) & 0xff) * a);
+		dst[3] = 255;
+		dst += 4;
+	}
+}
+
+void gr_row_blend_mask(unsigned char* dst, const unsigned char* mask,
+                       int n, unsigned int color)
+{
+	unsigned int a;
+	int i;
+
+	for (; n > 0; --n) {
+		a = div255(*mask++ * (color >> 24));
+		for (i = 0; i < 3; ++i)
+			dst[i] = div255(dst[i] * (255-a) + ((color >> (8*i)) & 0xff) * a);
+		dst[3] = 255;
+		dst += 4;
+	}
+}
+
+void gr_row_blend_argb(unsigned char* dst, const unsigned char* src, int n)
+{
+	unsigned int a;
+	int i;
+
+	for (; n > 0; --n) {
+		a = src[3];
+		for (i = 0; i < 3; ++i)
+			dst[i] = div255(dst[i] * (255-a) + src[i] * a);
+		dst[3] = 255;
+		dst += 4;
+		src += 4;
+	}
+}
+#endif
+
 static void text_blend(unsigned char* src_p, int src_row_bytes,
                        unsigned char* dst_p, int dst_row_bytes,
                        int width, int height)
 {
+	unsigned int color = gr_current_color();
 	int j = 0;
 
 	for (j = 0; j < height; ++j) {
-		int i = 0;
-		unsigned char* sx = src_p;
-		unsigned char* px = dst_p;
-
-		for (i = 0; i < width; ++i) {
-			unsigned char a = *sx++;
-			if (gr_current_a < 255)
-				a = ((int)a * gr_current_a) / 255;
-			if (a == 255) {
-				*px++ = gr_current_r;
-				*px++ = gr_current_g;
-				*px++ = gr_current_b;
-				*px++ = 255;
-			} else if (a > 0) {
-				*px = (*px * (255-a) + gr_current_r * a) / 255;
-				++px;
-				*px = (*px * (255-a) + gr_current_g * a) / 255;
-				++px;
-				*px = (*px * (255-a) + gr_current_b * a) / 255;
-				++px;
-				*px++ = 255;
-			} else {
-				px += 3;
-				*px++ = 255;
-			}
-		}
+		gr_row_blend_mask(dst_p, src_p, width, color);
 		src_p += src_row_bytes;
 		dst_p += dst_row_bytes;
 	}
@@ -102,6 +172,7 @@ static void text_blend(unsigned char* src_p, int src_row_bytes,
 void gr_text(const GRFont* font, int x, int y, const char *s, bool bold)
 {
 	unsigned char ch;
+	int x0;
 
 	if (!font->texture || gr_current_a == 0)
 		return;
@@ -110,6 +181,7 @@ void gr_text(const GRFont* font, int x, int y, const char *s, bool bold)
 
 	x += overscan_offset_x;
 	y += overscan_offset_y;
+	x0 = x;
 
 	while ((ch = *s++)) {
 		if (outside(x, y) || outside(x+font->char_width-1, y+font->char_height-1))
@@ -129,6 +201,7 @@ void gr_text(const GRFont* font, int x, int y, const char *s, bool bold)
 
 		x += font->char_width;
 	}
+	gr_mark_dirty(x0, y, x, y + font->char_height);
 }
 
 void gr_texticon(int x, int y, GRSurface* icon) {
@@ -151,6 +224,7 @@ void gr_texticon(int x, int y, GRSurface* icon) {
 	text_blend(src_p, icon->row_bytes,
 		dst_p, gr_draw->row_bytes,
 		icon->width, icon->height);
+	gr_mark_dirty(x, y, x + icon->width, y + icon->height);
 }
 
 void gr_color(unsigned char r, unsigned char g, unsigned char b, unsigned char a)
@@ -186,13 +260,13 @@ void gr_clear(void)
 			px += gr_draw->row_bytes - (gr_draw->width * gr_draw->pixel_bytes);
 		}
 	}
+	gr_mark_dirty(0, 0, gr_draw->width, gr_draw->height);
 }
 
 void gr_fill(int x1, int y1, int x2, int y2)
 {
 	unsigned char* p;
-	int x, y;
-	unsigned char* px;
+	int y;
 
 	x1 += overscan_offset_x;
 	y1 += overscan_offset_y;
@@ -202,39 +276,22 @@ void gr_fill(int x1, int y1, int x2, int y2)
 
 	if (outside(x1, y1) || outside(x2-1, y2-1))
 		return;
+	if (gr_current_a == 0)
+		return;
 	p = gr_draw->data + y1 * gr_draw->row_bytes + x1 * gr_draw->pixel_bytes;
-	if (gr_current_a == 255) {
-		for (y = y1; y < y2; ++y) {
-			px = p;
-			for (x = x1; x < x2; ++x) {
-				*px++ = gr_current_r;
-				*px++ = gr_current_g;
-				*px++ = gr_current_b;
-				*px++ = 255;
-			}
-			p += gr_draw->row_bytes;
-		}
-	} else if (gr_current_a > 0) {
-		for (y = y1; y < y2; ++y) {
-			px = p;
-			for (x = x1; x < x2; ++x) {
-				*px = (*px * (255-gr_current_a) + gr_current_r * gr_current_a) / 255;
-				++px;
-				*px = (*px * (255-gr_current_a) + gr_current_g * gr_current_a) / 255;
-				++px;
-				*px = (*px * (255-gr_current_a) + gr_current_b * gr_current_a) / 255;
-				++px;
-				*px++ = 255;
-			}
-			p += gr_draw->row_bytes;
-		}
+	for (y = y1; y < y2; ++y) {
+		if (gr_current_a == 255)
+			gr_row_fill(p, x2 - x1, gr_current_color());
+		else
+			gr_row_blend(p, x2 - x1, gr_current_color());
+		p += gr_draw->row_bytes;
 	}
+	gr_mark_dirty(x1, y1, x2, y2);
 }
 
 void gr_blit(GRSurface* source, int sx, int sy, int w, int h, int dx, int dy)
 {
 	int i;
-	int j;
 	unsigned char* src_p;
 	unsigned char* dst_p;
 
@@ -256,27 +313,14 @@ void gr_blit(GRSurface* source, int sx, int sy, int w, int h, int dx, int dy)
 	dst_p = gr_draw->data + dy*gr_draw->row_bytes + dx*gr_draw->pixel_bytes;
 
 	for (i = 0; i < h; ++i) {
-		if (source->pixel_bytes == 4) {
-			unsigned char *p0 = src_p;
-			unsigned char *p1 = dst_p;
-			unsigned char alpha = 255;
-			for (j = 0; j < w; j++) {
-				alpha = *(p0+3);
-				*p1 = (*p1 * (255-alpha) + *p0++ * alpha) / 255;
-				++p1;
-				*p1 = (*p1 * (255-alpha) + *p0++ * alpha) / 255;
-				++p1;
-				*p1 = (*p1 * (255-alpha) + *p0++ * alpha) / 255;
-				++p1;
-				*p1++ = 255;
-				++p0;
-			}
-		} else {
+		if (source->pixel_bytes == 4)
+			gr_row_blend_argb(dst_p, src_p, w);
+		else
 			memcpy(dst_p, src_p, w * source->pixel_bytes);
-		}
 		src_p += source->row_bytes;
 		dst_p += gr_draw->row_bytes;
 	}
+	gr_mark_dirty(dx, dy, dx + w, dy + h);
 }
 
 unsigned int gr_get_width(GRSurface* surface)
@@ -356,7 +400,19 @@ static void gr_init_default_font(void)
 
 void gr_flip(void)
 {
-	gr_draw = gr_backend->flip();
+	gr_draw = gr_backend->flip(&gr_dirty);
+	memset(&gr_dirty, 0, sizeof(gr_dirty));
+	gr_last_flip = get_timer(0);
+}
+
+int gr_flip_throttled(unsigned int min_interval_ms)
+{
+	if (gr_dirty.x1 >= gr_dirty.x2 ||
+	    get_timer(gr_last_flip) < min_interval_ms)
+		return 0;
+
+	gr_flip();
+	return 1;
 }
 
 int gr_init(void)
@@ -374,6 +430,9 @@ int gr_init(void)
 	overscan_offset_x = gr_draw->width * overscan_percent / 100;
 	overscan_offset_y = gr_draw->height * overscan_percent / 100;
 
+	// write back the cleared buffers whole once, from then on only
+	// what is drawn
+	gr_mark_dirty(0, 0, gr_draw->width, gr_draw->height);
 	gr_flip();
 	gr_flip();
 
@@ -383,6 +442,7 @@ int gr_init(void)
 void gr_exit(void)
 {
 	gr_backend->exit();
+	memset(&gr_dirty, 0, sizeof(gr_dirty));
 
 	if (gr_font) {
 		if (gr_font->texture) {
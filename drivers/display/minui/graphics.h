@@ -19,6 +19,11 @@
 
 #include "minui.h"
 
+// A rectangle of the surface, x2 and y2 excluded; empty if x1 >= x2.
+typedef struct {
+	int x1, y1, x2, y2;
+} GRRect;
+
 // TODO: lose the function pointers.
 typedef struct {
 	// Initializes the backend and returns a GRSurface* to draw into.
@@ -26,8 +31,10 @@ typedef struct {
 
 	// Causes the current drawing surface (returned by the most recent
 	// call to flip() or init()) to be displayed, and returns a new
-	// drawing surface.
-	GRSurface* (*flip)(void);
+	// drawing surface. 'dirty' is the area drawn since the last flip,
+	// the only area written back to the screen. The new surface is
+	// brought up to date with the screen.
+	GRSurface* (*flip)(const GRRect* dirty);
 
 	// Blank (or unblank) the screen.
 	void (*blank)( bool);
@@ -38,4 +45,12 @@ typedef struct {
 
 minui_backend* open_fbdev(void);
 
+// Row fill and blend, n pixels of 4 bytes. 'color' holds the bytes of a
+// pixel in memory order, the alpha in byte 3. Written pixels are opaque.
+void gr_row_fill(unsigned char* dst, int n, unsigned int color);
+void gr_row_blend(unsigned char* dst, int n, unsigned int color);
+void gr_row_blend_mask(unsigned char* dst, const unsigned char* mask,
+                       int n, unsigned int color);
+void gr_row_blend_argb(unsigned char* dst, const unsigned char* src, int n);
+
 #endif
@@ -17,6 +17,7 @@
 #include "graphics.h"
 #include "minui_log.h"
 #include "../osd/osd_hw.h"
+#include "../osd/osd_fb.h"
 #include <video_fb.h>
 
 #define DOUBLE_BUFFER
@@ -24,7 +25,7 @@
 static GraphicDevice *gdev = NULL;
 
 static GRSurface* fbdev_init(void);
-static GRSurface* fbdev_flip(void);
+static GRSurface* fbdev_flip(const GRRect* dirty);
 static void fbdev_blank(bool);
 static void fbdev_exit(void);
 extern int video_scale_bitmap(void);
@@ -166,22 +167,65 @@ static GRSurface* fbdev_init(void)
 	return gr_draw;
 }
 
-static GRSurface* fbdev_flip(void)
+static unsigned char* rect_start(GRSurface* s, const GRRect* r)
 {
+	return s->data + r->y1 * s->row_bytes + r->x1 * s->pixel_bytes;
+}
+
+// Copy the rectangle r of src to the same place in dst.
+static void copy_rect(GRSurface* dst, GRSurface* src, const GRRect* r)
+{
+	unsigned char* d = rect_start(dst, r);
+	unsigned char* s = rect_start(src, r);
+	int row = (r->x2 - r->x1) * src->pixel_bytes;
+	int y;
+
+	if (row == src->row_bytes) {
+		memcpy(d, s, row * (r->y2 - r->y1));
+		return;
+	}
+	for (y = r->y1; y < r->y2; ++y) {
+		memcpy(d, s, row);
+		d += dst->row_bytes;
+		s += src->row_bytes;
+	}
+}
+
+static void flush_rect(GRSurface* s, const GRRect* r)
+{
+	osd_flush_rect((ulong)rect_start(s, r), s->row_bytes,
+		(r->x2 - r->x1) * s->pixel_bytes, r->y2 - r->y1);
+}
+
+static GRSurface* fbdev_flip(const GRRect* dirty)
+{
+	bool empty = dirty->x1 >= dirty->x2;
+
 	if (double_buffered) {
+		GRSurface* drawn = gr_draw;
+
 		// Change gr_draw to point to the buffer currently displayed,
 		// then flip the driver so we're displaying the other buffer
 		// instead.
 		ui_logd("fbdev_flip:gr_draw=0x%lx\n",
 			(unsigned long)(unsigned char*)gr_draw->data);
-		flush_cache((unsigned long)gr_draw->data, gr_draw->row_bytes * gr_draw->height);
+		if (!empty)
+			flush_rect(drawn, dirty);
 		gr_draw = gr_framebuffer + displayed_buffer;
 		set_displayed_framebuffer(1-displayed_buffer);
+		// The new buffer is one frame behind: catch up on what was
+		// drawn, so callers may redraw only what changes.
+		if (!empty) {
+			copy_rect(gr_draw, drawn, dirty);
+			flush_rect(gr_draw, dirty);
+		}
 	} else {
 		// Copy from the in-memory surface to the framebuffer.
 		set_displayed_framebuffer(0);
-		memcpy(gr_framebuffer[0].data, gr_draw->data,
-			gr_draw->height * gr_draw->row_bytes);
+		if (!empty) {
+			copy_rect(gr_framebuffer, gr_draw, dirty);
+			flush_rect(gr_framebuffer, dirty);
+		}
 		ui_logd("flip: \n");
 	}
 	return gr_draw;
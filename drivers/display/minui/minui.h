@@ -32,6 +32,9 @@ int gr_fb_width(void);
 int gr_fb_height(void);
 
 void gr_flip(void);
+// Flip if anything was drawn and min_interval_ms passed since the last
+// flip, else keep drawing into the same surface. Returns 1 if flipped.
+int gr_flip_throttled(unsigned int min_interval_ms);
 void gr_fb_blank(bool blank);
 
 void gr_clear(void); // clear entire surface to current color
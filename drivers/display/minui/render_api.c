@@ -105,3 +105,8 @@ void screen_update(void)
 {
 	gr_flip();
 }
+
+int screen_update_throttled(unsigned int min_interval_ms)
+{
+	return gr_flip_throttled(min_interval_ms);
+}
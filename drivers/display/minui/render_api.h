@@ -33,5 +33,6 @@ void screen_setcolor(unsigned int color);
 void screen_drawtextline(const GRFont* font, int x, int y, const char *s, bool bold);
 void screen_fillrect(int x, int y, int w, int h);
 void screen_update(void);
+int screen_update_throttled(unsigned int min_interval_ms);
 
 #endif
@@ -488,99 +488,178 @@ void *video_hw_init(int display_mode)
 	return osd_hw_init();
 }
 
+#ifndef CONFIG_ARM64
+void osd_row_bgr24_to_bgra32(void *dst, const void *src, ulong n)
+{
+	const uchar *s = src;
+	uchar *d = dst;
+
+	while (n--) {
+		*d++ = *s++;
+		*d++ = *s++;
+		*d++ = *s++;
+		*d++ = 0xff;
+	}
+}
+
+void osd_row_bgr24_to_rgb565(void *dst, const void *src, ulong n)
+{
+	const uchar *s = src;
+	u16 *d = dst;
+
+	while (n--) {
+		*d++ = (s[2] >> 3) << 11 | (s[1] >> 2) << 5 | s[0] >> 3;
+		s += 3;
+	}
+}
+#endif
+
+/* opaque 32 bpp pixels of the BMP colour table */
+static void bmp_palette_lut(bmp_image_t *bmp, u32 *lut)
+{
+	unsigned colors = le32_to_cpu(bmp->header.colors_used);
+	unsigned i;
+
+	if (!colors || colors > 256)
+		colors = 256;
+	for (i = 0; i < colors; i++)
+		lut[i] = 0xff000000 | bmp->color_table[i].red << 16 |
+			 bmp->color_table[i].green << 8 |
+			 bmp->color_table[i].blue;
+	for (; i < 256; i++)
+		lut[i] = 0xff000000;
+}
+
+/*
+ * Decode a RLE8 BMP into width_bmp x height_bmp 32 bpp pixels at ptr,
+ * bottom row first like the BMP, through a lookup table of the palette.
+ */
 int rle8_decode(uchar *ptr, bmp_image_t *bmap_rle8, ulong width_bmp, ulong height_bmp) {
-	uchar a;
-	uchar cnt, runlen;
+	u32 lut[256];
+	u32 *out = (u32 *)ptr;
+	uchar cnt;
 	int i;
-	int decode;
-	int pixels;
+	ulong pixels;
 	uchar *pic;
-	int limit;
+	ulong limit;
 
-	a = 0xFF;
-	decode = 1;
+	bmp_palette_lut(bmap_rle8, lut);
 	pixels = 0;
 	limit = width_bmp * height_bmp;
 	pic = (uchar *)bmap_rle8 + le32_to_cpu(bmap_rle8->header.data_offset);
 
-	while (decode) {
+	while (1) {
 		switch (pic[0]) {
 		case 0:
 			switch (pic[1]) {
 			case 0:
-				/* end of row */
+				/* end of row, the rest of it is left as is */
+				if (pixels % width_bmp)
+					pixels += width_bmp - pixels % width_bmp;
 				pic += 2;
 				continue;
 			case 1:
 				/* end of bmp */
-				decode = 0;
-				break;
+				return 0;
 			case 2:
 				/* 00 02 mode */
 				pic += 4;
-				break;
+				continue;
 
 			default:
 				/* 00 (03~FF) mode */
 				cnt = pic[1];
-				runlen = cnt;
-				pixels += cnt;
-				if (pixels > limit)
-				{
+				if (pixels + cnt > limit) {
 					osd_loge("Error: Too much encoded pixel data, validate your bitmap\n");
-					decode = 0;
 					return -1;
 				}
 				pic += 2;
-				for (i = 0; i < cnt; i++) {
-
-					*ptr = bmap_rle8->color_table[*pic].blue;
-					ptr += 1;
-					*ptr = bmap_rle8->color_table[*pic].green;
-					ptr += 1;
-					*ptr = bmap_rle8->color_table[*pic].red;
-					ptr += 1;
-					*ptr = a;
-					ptr += 1;
-					pic += 1;
-				}
-				if (runlen & 1)
+				for (i = 0; i < cnt; i++)
+					out[pixels++] = lut[*pic++];
+				if (cnt & 1)
 					pic += 1;	/* 0 padding if length is odd */
-				break;
+				continue;
 			}
-			break;
 
 		default:
 			/* normal mode */
 			cnt = pic[0];
-			runlen = cnt;
-			pixels += cnt;
-			if (pixels > limit) {
+			if (pixels + cnt > limit) {
 				osd_loge("Error: Too much encoded pixel data, validate your bitmap\n");
 				return -1;
 			}
-			pic += 1;
-			for (i = 0; i < cnt; i++) {
-
-				*ptr = bmap_rle8->color_table[*pic].blue;
-				ptr += 1;
-				*ptr = bmap_rle8->color_table[*pic].green;
-				ptr += 1;
-				*ptr = bmap_rle8->color_table[*pic].red;
-				ptr += 1;
-				*ptr = a;
-				ptr += 1;
-			}
-			pic += 1;
-			break;
+			for (i = 0; i < cnt; i++)
+				out[pixels++] = lut[pic[1]];
+			pic += 2;
+			continue;
 		}
 	}
-	return (0);
+}
+
+/*
+ * Fill height rows of width pixels of the canvas at fb from src, each
+ * side stepping by its own stride (negative for bottom-up). Rows already
+ * in the framebuffer format are copied, as one block when both sides are
+ * contiguous; 24 bit rows are converted to 32 or 16 bpp.
+ */
+static int osd_fill_rows(uchar *fb, long fb_stride, const uchar *src,
+			 long src_stride, ulong width, ulong height,
+			 unsigned src_bpp, unsigned fb_bpp)
+{
+	void (*convert)(void *dst, const void *src, ulong n) = NULL;
+	ulong row = width * src_bpp / 8;
+	ulong i;
+
+	if (src_bpp != fb_bpp) {
+		if (src_bpp == 24 && fb_bpp == 32)
+			convert = osd_row_bgr24_to_bgra32;
+		else if (src_bpp == 24 && fb_bpp == 16)
+			convert = osd_row_bgr24_to_rgb565;
+		else {
+			osd_loge("error: gdev.bpp %d, but pic.bpp %d\n",
+				 fb_bpp, src_bpp);
+			return -1;
+		}
+	} else if (fb_stride == row && src_stride == row) {
+		memcpy(fb, src, row * height);
+		return 0;
+	}
+
+	for (i = 0; i < height; i++) {
+		if (convert)
+			convert(fb, src, width);
+		else
+			memcpy(fb, src, row);
+		fb += fb_stride;
+		src += src_stride;
+	}
+	return 0;
+}
+
+/*
+ * Write back the cache lines of a rectangle of rows bytes wide, height
+ * rows stepping by stride from the top left byte at start. Narrow
+ * rectangles such as a progress bar step are flushed row by row instead
+ * of over the whole width of the canvas.
+ */
+void osd_flush_rect(ulong start, ulong stride, ulong row, ulong height)
+{
+	ulong i;
+
+	if (!row || !height)
+		return;
+	if (row * 2 >= stride) {
+		flush_cache(start, (height - 1) * stride + row);
+		return;
+	}
+	for (i = 0; i < height; i++, start += stride)
+		flush_cache(start, row);
 }
 
 static int parse_bmp_info(ulong bmp_image)
 {
 	bmp_image_t *bmp = (bmp_image_t *)bmp_image;
+	s32 height;
 
 	if (!((bmp->header.signature[0] == 'B') &&
 		  (bmp->header.signature[1] == 'M'))) {
@@ -588,7 +667,9 @@ static int parse_bmp_info(ulong bmp_image)
 		return 1;
 	}
 	g_pic_info.pic_width = le32_to_cpu(bmp->header.width);
-	g_pic_info.pic_height = le32_to_cpu(bmp->header.height);
+	/* negative for top-down rows */
+	height = le32_to_cpu(bmp->header.height);
+	g_pic_info.pic_height = height < 0 ? -height : height;
 	g_pic_info.bpp = le16_to_cpu(bmp->header.bit_count);
 	return 0;
 }
@@ -599,14 +680,15 @@ int video_display_bitmap(ulong bmp_image, int x, int y)
 #if defined CONFIG_AML_VOUT
 	info = vout_get_current_vinfo();
 #endif
-	// ushort *cmap_base = NULL;
-	unsigned long byte_width;
-	ushort i, j;
+	ulong i, j;
 	uchar *fb;
 	bmp_image_t *bmp = (bmp_image_t *)bmp_image;
 	uchar *bmap;
-	ushort padded_line;
 	unsigned long width, height;
+	unsigned long src_width, src_height;
+	long src_stride, fb_stride;
+	int top_down;
+	int ret = 0;
 	unsigned long pheight;
 	unsigned long pwidth;
 	unsigned colors, bpix, bmp_bpix;
@@ -636,7 +718,6 @@ int video_display_bitmap(ulong bmp_image, int x, int y)
 	height = g_pic_info.pic_height;
 	bmp_bpix = g_pic_info.bpp;
 	colors = 1 << bmp_bpix;
-	uchar *buffer_rgb = NULL;
 	bpix = NBITS(info->vl_bpix);
 	if ((bpix != 1) && (bpix != 8) && (bpix != 16) && (bpix != 24) &&
 	    (bpix != 32)) {
@@ -683,17 +764,11 @@ int video_display_bitmap(ulong bmp_image, int x, int y)
 			break;
 		}
 	}
-	/*
-	 *  BMP format for Monochrome assumes that the state of a
-	 * pixel is described on a per Bit basis, not per Byte.
-	 *  So, in case of Monochrome BMP we should align widths
-	 * on a byte boundary and convert them from Bit to Byte
-	 * units.
-	 *  Probably, PXA250 and MPC823 process 1bpp BMP images in
-	 * their own ways, so make the converting to be MCC200
-	 * specific.
-	 */
-	padded_line = (width & 0x3) ? ((width & ~0x3) + 4) : (width);
+	/* BMP rows are padded to 32 bits, bottom row first unless top-down */
+	src_width = width;
+	src_height = height;
+	src_stride = ((width * bmp_bpix + 31) >> 5) << 2;
+	top_down = (s32)le32_to_cpu(bmp->header.height) < 0;
 
 	if ((x + width) > pwidth)
 		width = pwidth - x;
@@ -701,110 +776,60 @@ int video_display_bitmap(ulong bmp_image, int x, int y)
 		height = pheight - y;
 
 	bmap = (uchar *)bmp + le32_to_cpu(bmp->header.data_offset);
-	fb   = (uchar *)(osd_hw.fb_gem[osd_index].addr +
-			 (y + height - 1) * lcd_line_length + x * fb_gdev.gdfBytesPP);
+	if (top_down) {
+		fb = (uchar *)(osd_hw.fb_gem[osd_index].addr +
+			       y * lcd_line_length + x * fb_gdev.gdfBytesPP);
+		fb_stride = lcd_line_length;
+	} else {
+		fb = (uchar *)(osd_hw.fb_gem[osd_index].addr +
+			       (y + height - 1) * lcd_line_length + x * fb_gdev.gdfBytesPP);
+		fb_stride = -(long)lcd_line_length;
+	}
 
-	osd_logd("fb=0x%p; bmap=0x%p, width=%ld, height= %ld, lcd_line_length=%d, padded_line=%d, fb_gdev.fb_width=%d, fb_gdev.fb_height=%d \n",
-		 fb, bmap, width, height, lcd_line_length, padded_line,fb_gdev.fb_width,fb_gdev.fb_height);
+	osd_logd("fb=0x%p; bmap=0x%p, width=%ld, height= %ld, lcd_line_length=%d, src_stride=%ld, fb_gdev.fb_width=%d, fb_gdev.fb_height=%d \n",
+		 fb, bmap, width, height, lcd_line_length, src_stride, fb_gdev.fb_width, fb_gdev.fb_height);
 
 	if (bmp_bpix == 8) {
-		/* decode of RLE8 */
-		buffer_rgb = (uchar *)malloc(height * width * 4 * sizeof(uchar) + 1);
-		if (buffer_rgb == NULL) {
-			printf("Error:fail to malloc the memory!");
-			return (-1);
-		}
-	}
-	uchar *ptr_rgb = buffer_rgb;
-	switch (bmp_bpix) {
-	case 8:
-		if (bpix != 16)
-			byte_width = width;
-		else
-			byte_width = width * 2;
-		rle8_decode(ptr_rgb, bmp, width, height);
-		for (i = 0; i < height; ++i) {
-			for (j = 0; j < width; j++) {
-				if (bpix != 16) {
-					*(fb++) = *buffer_rgb;
-					buffer_rgb += 1;
-					*(fb++) = *buffer_rgb;
-					buffer_rgb += 1;
-					*(fb++) = *buffer_rgb;
-					buffer_rgb += 1;
-					*(fb++) = *buffer_rgb;
-					buffer_rgb += 1;
-				}
-				// else {
-				// 	*(uint16_t *)fb = cmap_base[*buffer_rgb++];
-				// 	fb += sizeof(uint16_t) / sizeof(*fb);
-				// }
-			}
-			buffer_rgb += (padded_line - width);
-			fb -= (byte_width * 4 + lcd_line_length);
-		}
-		buffer_rgb -= width*height*4;
-		free(buffer_rgb);
-		break;
-	case 16:
-		for (i = 0; i < height; ++i) {
-			for (j = 0; j < width; j++) {
+		u32 lut[256];
+		uchar *buffer_rgb;
 
-				*(fb++) = *(bmap++);
-				*(fb++) = *(bmap++);
-			}
-			bmap += (padded_line - width) * 2;
-			fb   -= (width * 2 + lcd_line_length);
+		if (bpix != 32) {
+			osd_loge("error: gdev.bpp %d, but bmp.bpp %d\n", bpix, bmp_bpix);
+			return (-1);
 		}
-		break;
-	case 24:
-		if (bpix == 32) {
-			for (i = 0; i < height; ++i) {
-				for (j = 0; j < width; j++) {
-
-					*(fb++) = *(bmap++);
-					*(fb++) = *(bmap++);
-					*(fb++) = *(bmap++);
-					*(fb++) = 0xff;
-				}
-				bmap += (padded_line - width);
-				fb   -= (width * 4 + lcd_line_length);
+		if (le32_to_cpu(bmp->header.compression) != BMP_BI_RLE8) {
+			bmp_palette_lut(bmp, lut);
+			for (i = 0; i < height; i++) {
+				for (j = 0; j < width; j++)
+					((u32 *)fb)[j] = lut[bmap[j]];
+				bmap += src_stride;
+				fb += fb_stride;
 			}
 		} else {
-			for (i = 0; i < height; ++i) {
-				for (j = 0; j < width; j++) {
-
-					*(fb++) = *(bmap++);
-					*(fb++) = *(bmap++);
-					*(fb++) = *(bmap++);
-				}
-				bmap += (padded_line - width);
-				fb   -= (width * 3 + lcd_line_length);
-			}
-		}
-		break;
-	case 32:
-		for (i = 0; i < height; ++i) {
-			for (j = 0; j < width; j++) {
-
-				*(fb++) = *(bmap++);
-				*(fb++) = *(bmap++);
-				*(fb++) = *(bmap++);
-				*(fb++) = *(bmap++);
+			/* decode of RLE8 */
+			buffer_rgb = (uchar *)calloc(src_width * src_height, 4);
+			if (buffer_rgb == NULL) {
+				printf("Error:fail to malloc the memory!");
+				return (-1);
 			}
-			bmap += (padded_line - width);
-			fb   -= (width * 4 + lcd_line_length);
+			ret = rle8_decode(buffer_rgb, bmp, src_width, src_height);
+			if (!ret)
+				ret = osd_fill_rows(fb, fb_stride, buffer_rgb,
+						    src_width * 4, width, height,
+						    32, 32);
+			free(buffer_rgb);
 		}
-		break;
-	default:
-		osd_loge("error: gdev.bpp %d, but bmp.bpp %d\n", fb_gdev.gdfBytesPP, bmp_bpix);
-		return (-1);
+	} else {
+		ret = osd_fill_rows(fb, fb_stride, bmap, src_stride, width,
+				    height, bmp_bpix, bpix);
 	}
-	buffer_rgb = NULL;
-	ptr_rgb = NULL;
+	if (ret)
+		return (-1);
 
-	flush_cache((unsigned long)osd_hw.fb_gem[osd_index].addr,
-		    pheight * CANVAS_ALIGNED(pwidth * info->vl_bpix / 8));
+	/* only the rows and columns drawn */
+	osd_flush_rect(osd_hw.fb_gem[osd_index].addr + y * lcd_line_length +
+		       x * fb_gdev.gdfBytesPP, lcd_line_length,
+		       width * bpix / 8, height);
 	return (0);
 }
 
@@ -814,7 +839,6 @@ int video_display_raw(ulong raw_image, int x, int y)
 #if defined CONFIG_AML_VOUT
 	info = vout_get_current_vinfo();
 #endif
-	ushort i, j;
 	uchar *fb;
 	uchar *bmap = (uchar *)raw_image;
 	ushort padded_line;
@@ -912,65 +936,15 @@ int video_display_raw(ulong raw_image, int x, int y)
 
 	if (FULL_SCREEN_MODE == fb_gdev.mode) {
 		memcpy(fb, bmap, height * width * bmp_bpix / 8);
-	} else {
-		switch (bmp_bpix) {
-		case 16:
-			for (i = 0; i < height; ++i) {
-				for (j = 0; j < width; j++) {
-
-					*(fb++) = *(bmap++);
-					*(fb++) = *(bmap++);
-				}
-				bmap += (padded_line - width) * 2;
-				fb   += (lcd_line_length - width * 2);
-			}
-			break;
-		case 24:
-			if (bpix == 32) {
-				for (i = 0; i < height; ++i) {
-					for (j = 0; j < width; j++) {
-
-						*(fb++) = *(bmap++);
-						*(fb++) = *(bmap++);
-						*(fb++) = *(bmap++);
-						*(fb++) = 0xff;
-					}
-					bmap += (padded_line - width) * 4;
-					fb   += (lcd_line_length - width * 4);
-				}
-			} else {
-				for (i = 0; i < height; ++i) {
-					for (j = 0; j < width; j++) {
-
-						*(fb++) = *(bmap++);
-						*(fb++) = *(bmap++);
-						*(fb++) = *(bmap++);
-					}
-					bmap += (padded_line - width) * 3;
-					fb   += (lcd_line_length - width * 3);
-				}
-			}
-			break;
-		case 32:
-			for (i = 0; i < height; ++i) {
-				for (j = 0; j < width; j++) {
-
-					*(fb++) = *(bmap++);
-					*(fb++) = *(bmap++);
-					*(fb++) = *(bmap++);
-					*(fb++) = *(bmap++);
-				}
-				bmap += (padded_line - width) * 4;
-				fb   += (lcd_line_length - width * 4);
-			}
-			break;
-		default:
-			osd_loge("error: gdev.bpp %d, but raw.bpp %d\n", fb_gdev.gdfBytesPP, bmp_bpix);
-			return (-1);
-		}
+		flush_cache((unsigned long)info->vd_base,
+			    pheight * pwidth * info->vl_bpix / 8);
+		return (0);
 	}
-	flush_cache((unsigned long)info->vd_base,
-		    pheight * pwidth * info->vl_bpix / 8);
+	if (osd_fill_rows(fb, lcd_line_length, bmap,
+			  padded_line * bmp_bpix / 8, width, height,
+			  bmp_bpix, bpix))
+		return (-1);
+	osd_flush_rect((ulong)fb, lcd_line_length, width * bpix / 8, height);
 	return (0);
 }
 
@@ -30,4 +30,10 @@ int img_display(ulong bmp_image, int x, int y);
 int img_scale(void);
 void img_raw_size_set(u32 raw_width, u32 raw_height, u32 raw_bpp);
 
+/* logo row converters, n pixels each */
+void osd_row_bgr24_to_bgra32(void *dst, const void *src, ulong n);
+void osd_row_bgr24_to_rgb565(void *dst, const void *src, ulong n);
+/* write back the cache of a rectangle of the canvas */
+void osd_flush_rect(ulong start, ulong stride, ulong row, ulong height);
+
 #endif
@@ -404,6 +404,44 @@ int key_unify_query_canOverWrite(const char* keyname, int* canOverWrite)
     return 0;
 }
 
+/*
+ * function name: key_unify_read_batch
+ * keys : keys to query, and read if buf set
+ * num  : number of keys
+ * return : number of keys failed, see err of each
+ * */
+int key_unify_read_batch(struct key_unify_batch_t* keys, const int num)
+{
+    int i;
+    int failed = 0;
+
+    for (i = 0; i < num; i++)
+    {
+        struct key_unify_batch_t* key = keys + i;
+        const KmDevKeyOps* theDevOps = _get_km_ops_by_name(key->name);
+
+        key->size = 0;
+        key->err  = 0;
+        if (!theDevOps || !theDevOps->pKeyExist(key->name))
+            key->err = -ENOENT;
+        else if (!theDevOps->pKeyCanRead(key->name))
+            key->err = -EACCES;
+        else {
+            key->size = theDevOps->pGetSize(key->name);
+            if (key->buf && key->size > key->bufLen)
+                key->err = -ENOSPC;
+            else if (key->buf && theDevOps->pReadFunc(key->name, key->buf, key->size))
+                key->err = -EIO;
+        }
+        if (key->err) {
+            KM_DBG("key[%s] batch err %d\n", key->name, key->err);
+            failed++;
+        }
+    }
+
+    return failed;
+}
+
 int do_keyunify (cmd_tbl_t * cmdtp, int flag, int argc, char * const argv[])
 {
     int err;
@@ -141,6 +141,8 @@ struct virtual_partition virtual_partition_table[] = {
 				  RANDOM_OFFSET, RANDOM_SIZE),
 	VIRTUAL_PARTITION_ELEMENT(MMC_DDR_PARAMETER_NAME,
 				  DDR_PARAMETER_OFFSET, DDR_PARAMETER_SIZE),
+	VIRTUAL_PARTITION_ELEMENT(MMC_TUNING_NAME,
+				  TUNING_OFFSET, TUNING_SIZE),
 };
 
 int get_emmc_partition_arraysize(void)
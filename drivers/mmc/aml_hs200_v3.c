@@ -32,6 +32,8 @@ Description:
 #include <asm/arch/secure_apb.h>
 #include <emmc_partitions.h>
 #include <asm/cpu_id.h>
+#include <u-boot/crc.h>
+#include <amlogic/aml_mmc.h>
 
 #ifdef EMMC_DEBUG_ENABLE
 	#define emmc_debug(a...) printf(a);
@@ -1072,6 +1074,162 @@ void mmc_set_clock_div(struct mmc *mmc, u32 src_speed) {
 	return ;
 }
 
+#ifdef MMC_HS400_MODE
+#define EMMC_TUNING_MAGIC	0x454e5554	/* "TUNE" */
+#define EMMC_TUNING_VERSION	1
+
+/* controller timing after aml_post_hs400_timming() */
+struct emmc_tuning_cache {
+	u32 magic;
+	u32 version;
+	u32 cid[4];
+	u32 clock;
+	u32 gclock;
+	u32 gdelay;
+	u32 gdelay1;
+	u32 gadjust;
+	u32 gintf3;
+	u32 gcfg;
+	u32 crc;	/* of all the above */
+};
+
+static struct emmc_tuning_cache tuning_cache;
+static int tuning_cache_valid;
+
+extern int aml_send_calibration_blocks(struct mmc *mmc, char *buffer,
+		u32 start_blk, u32 cnt);
+
+static lbaint_t emmc_rsv_blk(struct mmc *mmc, const char *name, u64 *size)
+{
+	struct partitions *part = aml_get_partition_by_name(MMC_RESERVED_NAME);
+	struct virtual_partition *vpart = aml_get_virtual_partition_by_name(name);
+
+	if (!part || !vpart)
+		return 0;
+	*size = vpart->size;
+	return (part->offset + vpart->offset) / mmc->read_bl_len;
+}
+
+void emmc_tuning_cache_read(struct mmc *mmc)
+{
+	lbaint_t blk;
+	u64 size;
+	u32 crc;
+	void *buf;
+
+	tuning_cache_valid = 0;
+	blk = emmc_rsv_blk(mmc, MMC_TUNING_NAME, &size);
+	if (!blk)
+		return;
+	buf = malloc(mmc->read_bl_len);
+	if (!buf)
+		return;
+	if (mmc_bread(mmc->block_dev.dev, blk, 1, buf) == 1) {
+		memcpy(&tuning_cache, buf, sizeof(tuning_cache));
+		crc = crc32(0, (u8 *)&tuning_cache,
+			offsetof(struct emmc_tuning_cache, crc));
+		tuning_cache_valid = (tuning_cache.magic == EMMC_TUNING_MAGIC)
+			&& (tuning_cache.version == EMMC_TUNING_VERSION)
+			&& (tuning_cache.crc == crc)
+			&& !memcmp(tuning_cache.cid, mmc->cid, sizeof(mmc->cid));
+	}
+	free(buf);
+}
+
+static void emmc_tuning_cache_write(struct mmc *mmc)
+{
+	struct aml_card_sd_info *aml_priv = mmc->priv;
+	struct sd_emmc_global_regs *sd_emmc_regs = aml_priv->sd_emmc_reg;
+	lbaint_t blk;
+	u64 size;
+	void *buf;
+
+	blk = emmc_rsv_blk(mmc, MMC_TUNING_NAME, &size);
+	if (!blk)
+		return;
+	buf = malloc(mmc->read_bl_len);
+	if (!buf)
+		return;
+
+	memset(buf, 0, mmc->read_bl_len);
+	tuning_cache.magic = EMMC_TUNING_MAGIC;
+	tuning_cache.version = EMMC_TUNING_VERSION;
+	memcpy(tuning_cache.cid, mmc->cid, sizeof(mmc->cid));
+	tuning_cache.clock = mmc->clock;
+	tuning_cache.gclock = sd_emmc_regs->gclock;
+	tuning_cache.gdelay = sd_emmc_regs->gdelay;
+	tuning_cache.gdelay1 = sd_emmc_regs->gdelay1;
+	tuning_cache.gadjust = sd_emmc_regs->gadjust;
+	tuning_cache.gintf3 = sd_emmc_regs->gintf3;
+	tuning_cache.gcfg = sd_emmc_regs->gcfg;
+	tuning_cache.crc = crc32(0, (u8 *)&tuning_cache,
+			offsetof(struct emmc_tuning_cache, crc));
+	memcpy(buf, &tuning_cache, sizeof(tuning_cache));
+
+	if (mmc_bwrite(mmc->block_dev.dev, blk, 1, buf) != 1)
+		printf("[%s] write tuning cache failed\n", __func__);
+	free(buf);
+}
+
+/* read the calibration pattern back with the current timing */
+static int emmc_tuning_pattern_check(struct mmc *mmc)
+{
+	lbaint_t blk;
+	u64 size;
+	u32 *buf;
+	int err;
+
+	blk = emmc_rsv_blk(mmc, MMC_PATTERN_NAME, &size);
+	if (!blk)
+		return -ENODEV;
+	buf = malloc(size);
+	if (!buf)
+		return -ENOMEM;
+
+	mmc->refix = 1;
+	err = aml_send_calibration_blocks(mmc, (char *)buf, blk,
+			size / mmc->read_bl_len);
+	mmc->refix = 0;
+	if (!err && buf[size / 4 - 1] != crc32(0, (u8 *)buf, size - 4))
+		err = -EIO;
+	free(buf);
+	return err;
+}
+
+/* restore the cached timing, return 0 if it reads the pattern fine */
+static int emmc_tuning_cache_apply(struct mmc *mmc)
+{
+	struct aml_card_sd_info *aml_priv = mmc->priv;
+	struct sd_emmc_global_regs *sd_emmc_regs = aml_priv->sd_emmc_reg;
+
+	if (!tuning_cache_valid || tuning_cache.clock != mmc->clock)
+		return -EINVAL;
+
+	sd_emmc_regs->gcfg = tuning_cache.gcfg;
+	sd_emmc_regs->gadjust = tuning_cache.gadjust;
+	sd_emmc_regs->gdelay = tuning_cache.gdelay;
+	sd_emmc_regs->gdelay1 = tuning_cache.gdelay1;
+	sd_emmc_regs->gintf3 = tuning_cache.gintf3;
+	sd_emmc_regs->gclock = tuning_cache.gclock;
+
+	return emmc_tuning_pattern_check(mmc);
+}
+
+/* enhanced strobe: cmd response is latched by data strobe too */
+static int emmc_enhanced_strobe(struct mmc *mmc)
+{
+#ifdef CONFIG_EMMC_HS400ES
+	ALLOC_CACHE_ALIGN_BUFFER(u8, ext_csd, MMC_MAX_BLOCK_LEN);
+
+	if (mmc_get_ext_csd(mmc, ext_csd))
+		return 0;
+	return ext_csd[EXT_CSD_STROBE_SUPPORT] & 0x1;
+#else
+	return 0;
+#endif
+}
+#endif /* MMC_HS400_MODE */
+
 /*
  * Function to enable HS400 mode
  * 1. Set the HS_TIMING on ext_csd 185 to 0x01
@@ -1083,6 +1241,9 @@ void mmc_set_clock_div(struct mmc *mmc, u32 src_speed) {
 uint32_t mmc_set_hs400_mode(struct mmc *mmc)
 {
 	uint32_t err;
+	int strobe = emmc_enhanced_strobe(mmc);
+	u32 vcfg;
+	struct sd_emmc_config *gcfg = (struct sd_emmc_config *)&vcfg;
 
 	struct aml_card_sd_info *aml_priv = mmc->priv;
 	struct sd_emmc_global_regs *sd_emmc_regs = aml_priv->sd_emmc_reg;
@@ -1099,8 +1260,9 @@ uint32_t mmc_set_hs400_mode(struct mmc *mmc)
 	mmc_set_clock(mmc, 50000000);
 
 	/* Set 8 bit DDR bus width */
-	err = mmc_switch(mmc, EXT_CSD_CMD_SET_NORMAL,
-				      EXT_CSD_BUS_WIDTH, 6);
+	err = mmc_switch(mmc, EXT_CSD_CMD_SET_NORMAL, EXT_CSD_BUS_WIDTH,
+			EXT_CSD_DDR_BUS_WIDTH_8 |
+			(strobe ? EXT_CSD_BUS_WIDTH_STROBE : 0));
 
 	if (err) {
 		printf("Switch cmd returned failure %d\n", __LINE__);
@@ -1117,6 +1279,12 @@ uint32_t mmc_set_hs400_mode(struct mmc *mmc)
 
 	mmc_set_ddr_mode(mmc);
 	mmc_set_ds_enable(mmc);
+	if (strobe) {
+		vcfg = sd_emmc_regs->gcfg;
+		gcfg->chk_ds = 1;
+		sd_emmc_regs->gcfg = vcfg;
+		printf("emmc hs400 enhanced strobe\n");
+	}
 
 	mmc_set_clock_phase(mmc, 0);
 
@@ -1135,7 +1303,15 @@ uint32_t mmc_set_hs400_mode(struct mmc *mmc)
 
 
 	sd_emmc_regs->gadjust = 0x8000;
+	if (!emmc_tuning_cache_apply(mmc)) {
+		printf("emmc hs400 timing restored from cache\n");
+		return err;
+	}
+
 	aml_post_hs400_timming(mmc);
+	/* only keep a timing which reads the pattern right */
+	if (!emmc_tuning_pattern_check(mmc))
+		emmc_tuning_cache_write(mmc);
 
 	return err;
 }
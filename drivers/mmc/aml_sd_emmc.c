@@ -47,6 +47,20 @@
 #endif
 
 extern bool aml_is_emmc_tsd (struct mmc *mmc);
+
+/* blocks one descriptor can carry, cmd_cfg.length is 9 bits */
+#define SD_EMMC_DESC_MAX_BLKS	511
+
+/*
+ * descriptors chained for one multi-block read/write, so b_max is
+ * SD_EMMC_DESC_MAX_BLKS times this, e.g. ~16MB for 64 with 512 bytes blocks.
+ */
+#ifndef CONFIG_AML_SD_EMMC_CHAIN_DESC
+#define CONFIG_AML_SD_EMMC_CHAIN_DESC	1
+#endif
+#if CONFIG_AML_SD_EMMC_CHAIN_DESC > (NEWSD_MAX_DESC_MUN >> 2)
+#error "CONFIG_AML_SD_EMMC_CHAIN_DESC exceeds the descriptor buffer"
+#endif
 /*
  * **********************************************************************************************
  * board relative
@@ -406,9 +420,9 @@ int aml_sd_send_cmd_ffu(struct mmc *mmc, struct mmc_cmd *cmd, struct mmc_data *d
 				printf("%s: No memory for write_buffer\n", __func__);
 				return -ENOMEM;
 			}
-			memset(write_buffer, 0, data->blocks * data->blocksize);
 			memcpy(write_buffer, (u32 *)data->src, data->blocks*data->blocksize);
-			flush_dcache_range((unsigned)(long)write_buffer,(unsigned long)(write_buffer+data->blocks*data->blocksize));
+			flush_dcache_range((unsigned long)write_buffer,
+					(unsigned long)write_buffer + data->blocks * data->blocksize);
 			if (data->blocks > 1) {
 				blks = data->blocks;
 				desc_cnt = 0;
@@ -532,6 +546,40 @@ int aml_sd_send_cmd_ffu(struct mmc *mmc, struct mmc_cmd *cmd, struct mmc_data *d
 	return SD_NO_ERROR;
 }
 
+/*
+ * Split the data of the command in @desc over a chain of descriptors of
+ * SD_EMMC_DESC_MAX_BLKS blocks at most, only the first one sends the
+ * command. Return the last descriptor of the chain.
+ */
+static struct sd_emmc_desc_info *aml_sd_chain_data(struct sd_emmc_desc_info *desc,
+		unsigned long addr, u32 blocks, u32 blocksize)
+{
+	struct cmd_cfg *des_cmd = (struct cmd_cfg *)&desc->cmd_info;
+	u32 data_wr = des_cmd->data_wr;
+	u32 len;
+
+	while (1) {
+		len = min_t(u32, blocks, SD_EMMC_DESC_MAX_BLKS);
+		des_cmd->block_mode = 1;
+		des_cmd->length = len;
+		des_cmd->data_num = 0;
+		des_cmd->owner = 1;
+		desc->data_addr = addr & ~(1<<0);   //DDR
+		blocks -= len;
+		addr += len * blocksize;
+		if (!blocks)
+			return desc;
+
+		desc++;
+		memset(desc, 0, sizeof(struct sd_emmc_desc_info));
+		des_cmd = (struct cmd_cfg *)&desc->cmd_info;
+		des_cmd->no_resp = 1;
+		des_cmd->no_cmd = 1;
+		des_cmd->data_io = 1;
+		des_cmd->data_wr = data_wr;
+	}
+}
+
 /*
  * Sends a command out on the bus. Takes the mmc pointer,
  * a command pointer, and an optional data pointer.
@@ -590,6 +638,11 @@ int aml_sd_send_cmd(struct mmc *mmc, struct mmc_cmd *cmd, struct mmc_data *data)
 			des_cmd_cur->data_wr = 0;  //read data from sd/emmc
 			buffer = (unsigned long)data->dest;//dma_map_single((void*)data->dest,data->blocks*data->blocksize,DMA_FROM_DEVICE);
 			invalidate_dcache_range((unsigned long)data->dest, (unsigned long)(data->dest+data->blocks*data->blocksize));
+		} else if (!((unsigned long)data->src & (ARCH_DMA_MINALIGN - 1))) {
+			/* aligned source is written in place, no bounce copy */
+			des_cmd_cur->data_wr = 1;
+			buffer = (unsigned long)data->src;
+			flush_dcache_range((unsigned long)data->src, (unsigned long)(data->src+data->blocks*data->blocksize));
 		} else {
 			des_cmd_cur->data_wr = 1;
 			//buffer = (unsigned long)data->src;//dma_map_single((void*)data->src,data->blocks*data->blocksize,DMA_TO_DEVICE);//(char *)data->src;
@@ -598,12 +651,20 @@ int aml_sd_send_cmd(struct mmc *mmc, struct mmc_cmd *cmd, struct mmc_data *data)
 				printf("%s: No memory for write_buffer\n", __func__);
 				return -ENOMEM;
 			}
-			memset(write_buffer, 0 ,data->blocks * data->blocksize);
+			/* mmc_bwrite() keeps unaligned writes to AML_MMC_BOUNCE_BLKS */
 			memcpy(write_buffer, (u32 *)data->src, data->blocks*data->blocksize);
-			flush_dcache_range((unsigned)(long)write_buffer,(unsigned long)(write_buffer+data->blocks*data->blocksize));
+			flush_dcache_range((unsigned long)write_buffer,
+					(unsigned long)write_buffer + data->blocks * data->blocksize);
 		}
 
-		if (data->blocks > 1) {
+		if (write_buffer)
+			buffer = (unsigned long)write_buffer;
+		if (data->blocks > SD_EMMC_DESC_MAX_BLKS) {
+			des_cmd_cur->owner = 1;
+			desc_cur = aml_sd_chain_data(desc_cur, buffer,
+					data->blocks, data->blocksize);
+			des_cmd_cur = (struct cmd_cfg *)&(desc_cur->cmd_info);
+		} else if (data->blocks > 1) {
 			des_cmd_cur->block_mode = 1;
 			des_cmd_cur->length = data->blocks;
 		} else {
@@ -611,11 +672,10 @@ int aml_sd_send_cmd(struct mmc *mmc, struct mmc_cmd *cmd, struct mmc_data *data)
 			des_cmd_cur->length = data->blocksize;
 		}
 		des_cmd_cur->data_num = 0;
-		if (des_cmd_cur->data_wr == 1)
-			desc_cur->data_addr = (unsigned long)write_buffer;
-		else
+		if (data->blocks <= SD_EMMC_DESC_MAX_BLKS) {
 			desc_cur->data_addr = buffer;
-		desc_cur->data_addr &= ~(1<<0);   //DDR
+			desc_cur->data_addr &= ~(1<<0);   //DDR
+		}
 
 	}
 	if (data) {
@@ -641,13 +701,14 @@ int aml_sd_send_cmd(struct mmc *mmc, struct mmc_cmd *cmd, struct mmc_data *data)
 	desc_start->init = 0;
 	desc_start->busy = 1;
 	desc_start->addr = (unsigned long)aml_priv->desc_buf >> 2;
-#if 0
-	sd_emmc_reg->gstart = vstart;
-#else
-	sd_emmc_reg->gcmd_cfg = desc_cur->cmd_info;
-	sd_emmc_reg->gcmd_dat = desc_cur->data_addr;
-	sd_emmc_reg->gcmd_arg = desc_cur->cmd_arg;
-#endif
+	if (desc_cur != (struct sd_emmc_desc_info *)aml_priv->desc_buf) {
+		/* chained descriptors are fetched from desc_buf by the host */
+		sd_emmc_reg->gstart = vstart;
+	} else {
+		sd_emmc_reg->gcmd_cfg = desc_cur->cmd_info;
+		sd_emmc_reg->gcmd_dat = desc_cur->data_addr;
+		sd_emmc_reg->gcmd_arg = desc_cur->cmd_arg;
+	}
 	//waiting end of chain
 	//mmc->refix = 0;
 	while (1) {
@@ -721,7 +782,7 @@ int aml_sd_send_cmd(struct mmc *mmc, struct mmc_cmd *cmd, struct mmc_data *data)
 	sd_debug("cmd->response[1]=0x%x;\n",cmd->response[1]);
 	sd_debug("cmd->response[2]=0x%x;\n",cmd->response[2]);
 	sd_debug("cmd->response[3]=0x%x;\n",cmd->response[3]);
-	if (des_cmd_cur->data_wr == 1) {
+	if (write_buffer) {
 		free(write_buffer);
 		write_buffer = NULL;
 	}
@@ -1137,7 +1198,7 @@ void sd_emmc_register(struct aml_card_sd_info * aml_priv)
 #else
 	cfg->part_type = PART_TYPE_AML;
 #endif
-	cfg->b_max = 256;
+	cfg->b_max = SD_EMMC_DESC_MAX_BLKS * CONFIG_AML_SD_EMMC_CHAIN_DESC;
 	mmc_create(cfg,aml_priv);
 }
 
@@ -1464,6 +1464,11 @@ static int mmc_startup(struct mmc *mmc)
 			* ext_csd[EXT_CSD_HC_WP_GRP_SIZE];
 
 		mmc->part_support = ext_csd[EXT_CSD_PARTITIONING_SUPPORT];
+
+		/* for mmc_trim_zero(), so it needs no CMD8 per call */
+		mmc->trim_zero = (ext_csd[EXT_CSD_SEC_FEATURE_SUPPORT] &
+				  EXT_CSD_SEC_GB_CL_EN) &&
+				 !ext_csd[EXT_CSD_ERASED_MEM_CONT];
 	}
 
 	err = mmc_set_capacity(mmc, mmc->part_num);
@@ -1903,6 +1908,10 @@ int mmc_init(struct mmc *mmc)
 	info_disprotect &= ~DISPROTECT_KEY;
 #endif
 #ifdef MMC_HS200_MODE
+#ifdef MMC_HS400_MODE
+	/* still in the slow bus mode the cached timing is safely read in */
+	emmc_tuning_cache_read(mmc);
+#endif
 	mmc_set_hs200_mode(mmc);
 #ifdef MMC_HS400_MODE
 	mmc_set_hs400_mode(mmc);
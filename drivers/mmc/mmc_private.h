@@ -37,6 +37,8 @@ extern int mmc_set_hs200_mode(struct mmc *mmc);
 
 extern uint32_t mmc_set_hs400_mode(struct mmc *mmc);
 
+extern void emmc_tuning_cache_read(struct mmc *mmc);
+
 extern void reset_all_reg(struct mmc *mmc);
 #else /* CONFIG_SPL_BUILD */
 
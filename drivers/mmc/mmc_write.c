@@ -12,11 +12,14 @@
 #include <part.h>
 #include "mmc_private.h"
 #include <malloc.h>
+#include <amlogic/aml_mmc.h>
 
 extern bool emmckey_is_access_range_legal(struct mmc *mmc,
 		ulong start, lbaint_t blkcnt);
 
-static ulong mmc_erase_t(struct mmc *mmc, ulong start, lbaint_t blkcnt)
+/* CMD35/36/38, @arg selects the kind of erase */
+static ulong mmc_erase_cmd(struct mmc *mmc, ulong start, lbaint_t blkcnt,
+		uint arg)
 {
 	struct mmc_cmd cmd;
 	ulong end;
@@ -28,7 +31,6 @@ static ulong mmc_erase_t(struct mmc *mmc, ulong start, lbaint_t blkcnt)
 		end = (start + blkcnt - 1) * mmc->write_bl_len;
 		start *= mmc->write_bl_len;
 	}
-	printf("start = %lu,end = %lu\n",start,end);
 	if (IS_SD(mmc)) {
 		start_cmd = SD_CMD_ERASE_WR_BLK_START;
 		end_cmd = SD_CMD_ERASE_WR_BLK_END;
@@ -53,7 +55,7 @@ static ulong mmc_erase_t(struct mmc *mmc, ulong start, lbaint_t blkcnt)
 		goto err_out;
 
 	cmd.cmdidx = MMC_CMD_ERASE;
-	cmd.cmdarg = SECURE_ERASE;
+	cmd.cmdarg = arg;
 	cmd.resp_type = MMC_RSP_R1b;
 
 	err = mmc_send_cmd(mmc, &cmd, NULL);
@@ -67,6 +69,42 @@ err_out:
 	return err;
 }
 
+static ulong mmc_erase_t(struct mmc *mmc, ulong start, lbaint_t blkcnt)
+{
+	printf("start = %lu,end = %lu\n", start, start + blkcnt - 1);
+	return mmc_erase_cmd(mmc, start, blkcnt, SECURE_ERASE);
+}
+
+/*
+ * Trim blkcnt blocks at start, so they read as zeros, instead of writing
+ * zeros. TRIM takes write block addresses, so no erase group alignment is
+ * needed, and unlike the secure erase of mmc_berase() it doesn't purge.
+ * Returns -1 if the device has no TRIM or its erased memory doesn't read
+ * as zeros, the caller then writes zeros itself.
+ */
+int mmc_trim_zero(int dev_num, lbaint_t start, lbaint_t blkcnt)
+{
+	struct mmc *mmc = find_mmc_device(dev_num);
+	int timeout = 1000;
+
+	/* trim_zero is read from ext_csd once in mmc_startup() */
+	if (!mmc || IS_SD(mmc) || !mmc->trim_zero || !blkcnt)
+		return -1;
+	if (start + blkcnt > mmc->block_dev.lba)
+		return -1;
+	if (!emmckey_is_access_range_legal(mmc, start, blkcnt))
+		return -1;
+
+	if (mmc_erase_cmd(mmc, start, blkcnt, MMC_TRIM_ARG))
+		return -1;
+
+	/* Waiting for the ready status */
+	if (mmc_send_status(mmc, timeout))
+		return -1;
+
+	return 0;
+}
+
 unsigned long mmc_berase_becalled(int dev_num, lbaint_t start, lbaint_t blkcnt)
 {
 	int err = 0;
@@ -291,6 +329,11 @@ ulong mmc_bwrite(int dev_num, lbaint_t start, lbaint_t blkcnt, const void *src)
 	do {
 		cur = (blocks_todo > mmc->cfg->b_max) ?
 			mmc->cfg->b_max : blocks_todo;
+#ifdef CONFIG_AML_SD_EMMC
+		if (((unsigned long)src & (ARCH_DMA_MINALIGN - 1))
+				&& cur > AML_MMC_BOUNCE_BLKS)
+			cur = AML_MMC_BOUNCE_BLKS;
+#endif
 		if (mmc_write_blocks(mmc, start, cur, src) != cur)
 			return 0;
 		blocks_todo -= cur;
@@ -174,6 +174,7 @@ typedef union nand_core_clk {
 #define NAND_KEY_BLOCK_NUM 8
 #define NAND_DTB_BLOCK_NUM 4
 #define NAND_DDR_BLOCK_NUM 2
+#define NAND_RRT_BLOCK_NUM 2
 
 #define AML_CHIP_NONE_RB	4
 #define AML_INTERLEAVING_MODE	8
@@ -242,6 +243,7 @@ typedef union nand_core_clk {
 #define SEC_NAND_MAGIC	"nsec"
 #define DTB_NAND_MAGIC  "ndtb"
 #define DDR_NAND_MAGIC  "nddr"
+#define RRT_NAND_MAGIC  "nrrt"
 #define NAND_SYS_PART_SIZE	0x8000000
 
 struct aml_nand_flash_dev {
@@ -317,7 +319,10 @@ struct aml_nand_bch_desc {
     unsigned user_byte_mode;
 };
 
-//#define NEW_NAND_SUPPORT
+/* read retry, slc mode and dynamic read of mlc/tlc nand */
+#ifdef CONFIG_AML_MTD_NEW_NAND
+#define NEW_NAND_SUPPORT
+#endif
 
 #ifdef NEW_NAND_SUPPORT
 #define RETRY_NAND_MAGIC	"refv"
@@ -357,6 +362,8 @@ struct aml_nand_bch_desc {
 #define	SANDISK_19NM	50
 #define	SANDISK_24NM	51
 #define	SANDISK_A19NM	52
+#define	SANDISK_A19NM_4G	53
+#define	INTEL_20NM	60
 
 
 #define	DYNAMIC_REG_NUM	3
@@ -404,6 +411,8 @@ struct aml_nand_read_retry {
 	u8 retry_cnt;
 	u8 default_flag;
 	u8 cur_cnt[MAX_CHIP_NUM];
+	/* in read retry mode, precondition sent, until read_retry_exit() */
+	u8 retry_mode[MAX_CHIP_NUM];
 	u8 reg_addr[READ_RETRY_REG_NUM];
 	u8 reg_default_value[MAX_CHIP_NUM][READ_RETRY_REG_NUM];
 	char reg_offset_value[MAX_CHIP_NUM][READ_RETRY_CNT][READ_RETRY_REG_NUM];
@@ -414,6 +423,23 @@ struct aml_nand_read_retry {
 	void (*read_retry_exit)(struct mtd_info *mtd, int chipnr);
 };
 
+/* regions of a chip a read retry level is learnt for */
+#define NAND_RETRY_REGION_NUM	256
+
+/* kept in the "nrrt" reserved area */
+struct aml_nand_retry_cache {
+	/* last good read retry level + 1 of each region, 0 for none */
+	u8 level[MAX_CHIP_NUM][NAND_RETRY_REGION_NUM];
+};
+
+/* since power on */
+struct aml_nand_retry_stat {
+	unsigned int pages;	/* pages read with read retry */
+	unsigned int steps;	/* retry levels tried on them */
+	unsigned int hits;	/* pages read at once with the learnt level */
+	unsigned int failed;	/* pages failed on all the levels */
+};
+
 struct aml_nand_slc_program {
 	u8 flag;
 	u8 reg_cnt;
@@ -518,6 +544,10 @@ struct aml_nand_chip {
 	struct aml_nand_bch_desc *bch_desc;
 #ifdef NEW_NAND_SUPPORT
 	struct new_tech_nand_t  new_nand_info;
+	struct aml_nandrsv_info_t *aml_nandrrt_info;
+	struct aml_nand_retry_cache retry_cache;
+	struct aml_nand_retry_stat retry_stat;
+	u8 retry_cache_dirty;
 #endif
 	/* platform info */
 	struct aml_nand_platform *platform;
@@ -736,6 +766,42 @@ int amlnf_dtb_init(struct aml_nand_chip *aml_chip);
 
 int aml_key_init(struct aml_nand_chip *aml_chip);
 
+#ifdef NEW_NAND_SUPPORT
+extern unsigned char pagelist_hynix256[128];
+extern unsigned char pagelist_1ynm_hynix256_mtd[128];
+
+void aml_nand_get_read_default_value_hynix(struct mtd_info *mtd);
+void aml_nand_save_read_default_value_hynix(struct mtd_info *mtd);
+void aml_nand_get_slc_default_value_hynix(struct mtd_info *mtd);
+void aml_nand_enter_enslc_mode_hynix(struct mtd_info *mtd);
+void aml_nand_exit_enslc_mode_hynix(struct mtd_info *mtd);
+void aml_nand_read_retry_handle_hynix(struct mtd_info *mtd, int chipnr);
+void aml_nand_read_retry_exit_hynix(struct mtd_info *mtd, int chipnr);
+void aml_nand_read_retry_handle_toshiba(struct mtd_info *mtd, int chipnr);
+void aml_nand_read_retry_exit_toshiba(struct mtd_info *mtd, int chipnr);
+void aml_nand_read_retry_handle_samsung(struct mtd_info *mtd, int chipnr);
+void aml_nand_read_retry_exit_samsung(struct mtd_info *mtd, int chipnr);
+void aml_nand_read_retry_handle_micron(struct mtd_info *mtd, int chipnr);
+void aml_nand_read_retry_exit_micron(struct mtd_info *mtd, int chipnr);
+void aml_nand_read_retry_handle_intel(struct mtd_info *mtd, int chipnr);
+void aml_nand_read_retry_exit_intel(struct mtd_info *mtd, int chipnr);
+void aml_nand_dynamic_read_init(struct mtd_info *mtd);
+void aml_nand_dynamic_read_handle(struct mtd_info *mtd, int page, int chipnr);
+void aml_nand_dynamic_read_exit(struct mtd_info *mtd, int chipnr);
+void aml_nand_read_retry_handle_sandisk(struct mtd_info *mtd, int chipnr);
+void aml_nand_read_retry_handleA19_sandisk(struct mtd_info *mtd, int chipnr);
+void aml_nand_read_retry_exit_A19_sandisk(struct mtd_info *mtd, int chipnr);
+void aml_nand_enter_slc_mode_sandisk(struct mtd_info *mtd);
+void aml_nand_exit_slc_mode_sandisk(struct mtd_info *mtd);
+
+int aml_rrt_init(struct aml_nand_chip *aml_chip);
+
+void aml_nand_retry_cache_start(struct mtd_info *mtd, int chipnr, int page);
+
+void aml_nand_retry_cache_done(struct mtd_info *mtd,
+	int chipnr, int page, int steps, int ok);
+#endif
+
 int aml_nand_bbt_check(struct mtd_info *mtd);
 
 int aml_nand_rsv_info_check_except_bbt(struct mtd_info *mtd);
@@ -44,8 +44,6 @@ extern struct aml_nand_flash_dev aml_nand_flash_ids[];
 extern struct hw_controller *controller;
 
 #define NAND_CMD_SANDISK_DSP_OFF 0x25
-#define	SANDISK_A19NM_4G 53
-#define	INTEL_20NM 60
 
 /*
 static struct nand_ecclayout aml_nand_oob_64 = {
@@ -604,7 +602,7 @@ int aml_nand_slcprog_1ynm_hynix(struct mtd_info *mtd,
 	struct nand_chip * chip = mtd->priv;
 	unsigned char *data_buf;
 	loff_t op_add ;
-	unsigned op_page_add. temp_value;
+	unsigned op_page_add, temp_value;
 	unsigned priv_slc_page, next_msb_page;
 
 	temp_value = pagelist_1ynm_hynix256_mtd[offset_in_blk];
@@ -1028,13 +1026,18 @@ uint8_t aml_nand_set_reg_value_toshiba(struct aml_nand_chip *aml_chip,
 
 	aml_chip->aml_nand_select_chip(aml_chip, chipnr);
 
-	if (aml_chip->new_nand_info.read_rety_info.cur_cnt[chipnr] ==0) {
+	/*
+	 * the first retry of a page may not start at level 0,
+	 * see aml_nand_retry_cache_start().
+	 */
+	if (!aml_chip->new_nand_info.read_rety_info.retry_mode[chipnr]) {
 		aml_chip->aml_nand_command(aml_chip,
 			NAND_CMD_TOSHIBA_PRE_CON1, -1, -1, chipnr);
 	        NFC_SEND_CMD_IDLE(controller, 2);
 		aml_chip->aml_nand_command(aml_chip,
 			NAND_CMD_TOSHIBA_PRE_CON2, -1, -1, chipnr);
 	        NFC_SEND_CMD_IDLE(controller, 2);
+		aml_chip->new_nand_info.read_rety_info.retry_mode[chipnr] = 1;
 	}
 
 	for (j=0; j<cnt; j++) {
@@ -1120,6 +1123,8 @@ void aml_nand_read_retry_exit_toshiba(struct mtd_info *mtd, int chipnr)
 
 	memset(&aml_chip->new_nand_info.read_rety_info.cur_cnt[0],
 		0, MAX_CHIP_NUM);
+	memset(&aml_chip->new_nand_info.read_rety_info.retry_mode[0],
+		0, MAX_CHIP_NUM);
 }
 
 
@@ -1284,7 +1289,7 @@ void aml_nand_read_retry_handle_intel(struct mtd_info *mtd, int chipnr)
 	int cur_cnt;
 	int advance = 1;
 
-	cu_cnt = aml_chip->new_nand_info.read_rety_info.cur_cnt[chipnr];
+	cur_cnt = aml_chip->new_nand_info.read_rety_info.cur_cnt[chipnr];
 	printk("intel NAND set partmeters here and read_retry_cnt:%d\n",
 		cur_cnt );
 	if (cur_cnt == 3)
@@ -1420,9 +1425,9 @@ void aml_nand_dynamic_read_handle(struct mtd_info *mtd, int page, int chipnr)
 		return;
 
 	cur_upper_page =
-	new_nand_info->dynamic_read_info.cur_upper_page[chipnr];
+	new_nand_info->dynamic_read_info.cur_case_num_upper_page[chipnr];
 	cur_lower_page =
-	new_nand_info->dynamic_read_info.cur_lower_page[chipnr];
+	new_nand_info->dynamic_read_info.cur_case_num_lower_page[chipnr];
 
 	pages_per_blk = (1 << (chip->phys_erase_shift - chip->page_shift));
 	if (((page !=0) && (page % 2 ) == 0) || (page == (pages_per_blk -1))) {
@@ -2771,9 +2776,8 @@ int aml_nand_read_page_hwecc(struct mtd_info *mtd,
 		* aml_chip->user_byte_mode);
 
 #ifdef NEW_NAND_SUPPORT
-	int page_temp, pages_per_blk;
+	int page_temp, pages_per_blk, readretry_failed_cnt = 0;
 
-	readretry_failed_cnt = 0
 	pages_per_blk =
 		(1 << (chip->phys_erase_shift - chip->page_shift));
 	int retry_cnt =aml_chip->new_nand_info.read_rety_info.retry_cnt;
@@ -2965,6 +2969,8 @@ if (aml_chip->new_nand_info.type == SANDISK_19NM) {
 	aml_nand_debug("read ecc failed page:%d blk %d chip%d, retry_cnt:%d\n",
 		page_addr, (page_addr >> pages_per_blk_shift),
 		i, readretry_failed_cnt);
+		if (readretry_failed_cnt == 1)
+			aml_nand_retry_cache_start(mtd, i, page_addr);
 		aml_chip->new_nand_info.read_rety_info.read_retry_handle(mtd,
 			i);
 		aml_chip->aml_nand_command(aml_chip,
@@ -3043,8 +3049,11 @@ if ((aml_chip->new_nand_info.type == SANDISK_19NM)
 		aml_chip->new_nand_info.dynamic_read_info.dynamic_read_exit(mtd,
 			i);
 else if((aml_chip->new_nand_info.type)
-	&& (aml_chip->new_nand_info.read_rety_info.read_retry_exit))
+	&& (aml_chip->new_nand_info.read_rety_info.read_retry_exit)) {
+		aml_nand_retry_cache_done(mtd, i, page_addr,
+			min(readretry_failed_cnt, retry_cnt), stat >= 0);
 		aml_chip->new_nand_info.read_rety_info.read_retry_exit(mtd, i);
+}
 			}
 #endif
 			oob_buf += user_byte_num;
@@ -3222,10 +3231,10 @@ int aml_nand_read_oob(struct mtd_info *mtd, struct nand_chip *chip, int page)
 	unsigned nand_read_size = mtd->oobavail, dma_once_size;
 	unsigned read_chip_num;
 	int ran_mode = aml_chip->ran_mode;
-	int32_t error=0, i, stat=0, j=0,
+	int32_t error=0, i, stat=0, j=0, temp;
 
 #ifdef NEW_NAND_SUPPORT
-	int page_temp, readretry_failed_cnt = 0,
+	int page_temp, readretry_failed_cnt = 0;
 	int pages_per_blk =  (1 << (chip->phys_erase_shift - chip->page_shift));
 	int retry_cnt = aml_chip->new_nand_info.read_rety_info.retry_cnt;
 
@@ -0,0 +1,172 @@
+/*
+* Copyright (C) 2017 Amlogic, Inc. All rights reserved.
+* *
+This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+* *
+This program is distributed in the hope that it will be useful, but WITHOUT
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+* more details.
+* *
+You should have received a copy of the GNU General Public License along
+* with this program; if not, write to the Free Software Foundation, Inc.,
+* 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+* *
+Description: read retry level learnt per region, kept in rsv area.
+*/
+
+#include <common.h>
+#include <nand.h>
+#include <asm/io.h>
+#include <malloc.h>
+#include "aml_mtd.h"
+
+#ifdef NEW_NAND_SUPPORT
+struct aml_nand_chip *aml_chip_rrt = NULL;
+
+static u8 *aml_rrt_level(struct aml_nand_chip *aml_chip, int chipnr, int page)
+{
+	struct nand_chip *chip = &aml_chip->chip;
+	unsigned int blks, blk;
+
+	blks = (unsigned int)(chip->chipsize >> chip->phys_erase_shift);
+	blk = (page >> (chip->phys_erase_shift - chip->page_shift)) % blks;
+
+	return &aml_chip->retry_cache.level[chipnr]
+		[(u64)blk * NAND_RETRY_REGION_NUM / blks];
+}
+
+/*
+ * first read retry of a page, start at the level
+ * which read its region last time.
+ */
+void aml_nand_retry_cache_start(struct mtd_info *mtd, int chipnr, int page)
+{
+	struct aml_nand_chip *aml_chip = mtd_to_nand_chip(mtd);
+	u8 *level = aml_rrt_level(aml_chip, chipnr, page);
+
+	aml_chip->retry_stat.pages++;
+	if (*level)
+		aml_chip->new_nand_info.read_rety_info.cur_cnt[chipnr] =
+			*level - 1;
+}
+
+/*
+ * read retry of a page done after @steps levels, learn the
+ * level if @ok. must be called before read_retry_exit() which
+ * clears cur_cnt.
+ */
+void aml_nand_retry_cache_done(struct mtd_info *mtd,
+	int chipnr, int page, int steps, int ok)
+{
+	struct aml_nand_chip *aml_chip = mtd_to_nand_chip(mtd);
+	struct aml_nand_read_retry *retry_info =
+		&aml_chip->new_nand_info.read_rety_info;
+	u8 *level = aml_rrt_level(aml_chip, chipnr, page);
+	int cur;
+
+	aml_chip->retry_stat.steps += steps;
+	if (!ok) {
+		aml_chip->retry_stat.failed++;
+		return;
+	}
+	if ((steps == 1) && *level)
+		aml_chip->retry_stat.hits++;
+
+	/* handle() set cur_cnt and moved to the next, some wrap to 0 */
+	cur = retry_info->cur_cnt[chipnr];
+	cur = cur ? cur - 1 : retry_info->retry_cnt - 1;
+	if ((cur < 0xff) && (*level != cur + 1)) {
+		*level = cur + 1;
+		aml_chip->retry_cache_dirty = 1;
+	}
+}
+
+void amlnf_rrt_info(void)
+{
+	struct aml_nand_chip *aml_chip = aml_chip_rrt;
+	struct aml_nand_retry_stat *stat;
+	int i, j, regions = 0;
+
+	if (aml_chip == NULL) {
+		printk("%s: no read retry nand\n", __func__);
+		return;
+	}
+	stat = &aml_chip->retry_stat;
+	for (i = 0; i < MAX_CHIP_NUM; i++)
+		for (j = 0; j < NAND_RETRY_REGION_NUM; j++)
+			if (aml_chip->retry_cache.level[i][j])
+				regions++;
+
+	printk("read retry: %u pages, %u levels tried, %u learnt hits, "
+		"%u failed\n", stat->pages, stat->steps, stat->hits,
+		stat->failed);
+	printk("learnt regions: %d%s\n", regions,
+		aml_chip->retry_cache_dirty ? " (not saved)" : "");
+}
+
+int amlnf_rrt_save(void)
+{
+	struct aml_nand_chip *aml_chip = aml_chip_rrt;
+	int ret;
+
+	if (aml_chip == NULL) {
+		printk("%s: no read retry nand\n", __func__);
+		return -EFAULT;
+	}
+	if (!aml_chip->retry_cache_dirty)
+		return 0;
+	ret = aml_nand_ext_save_rsv_info(&aml_chip->mtd,
+		aml_chip->aml_nandrrt_info, (u_char *)&aml_chip->retry_cache);
+	if (ret) {
+		printk("%s save rrt error\n", __func__);
+		return -EFAULT;
+	}
+	aml_chip->retry_cache_dirty = 0;
+	return 0;
+}
+
+int amlnf_rrt_erase(void)
+{
+	struct aml_nand_chip *aml_chip = aml_chip_rrt;
+	int ret;
+
+	if (aml_chip == NULL) {
+		printk("%s: no read retry nand\n", __func__);
+		return -EFAULT;
+	}
+	memset(&aml_chip->retry_cache, 0, sizeof(aml_chip->retry_cache));
+	aml_chip->retry_cache_dirty = 0;
+	ret = aml_nand_ext_erase_rsv_info(&aml_chip->mtd,
+		aml_chip->aml_nandrrt_info);
+	if (ret) {
+		printk("%s erase rrt error\n", __func__);
+		ret = -EFAULT;
+	}
+	return ret;
+}
+
+int aml_rrt_init(struct aml_nand_chip *aml_chip)
+{
+	struct new_tech_nand_t *new_nand_info = &aml_chip->new_nand_info;
+
+	if (!new_nand_info->type || (new_nand_info->type == SANDISK_19NM)
+		|| !new_nand_info->read_rety_info.read_retry_handle)
+		return 0;
+
+	aml_chip_rrt = aml_chip;
+	memset(&aml_chip->retry_cache, 0, sizeof(aml_chip->retry_cache));
+	memset(&aml_chip->retry_stat, 0, sizeof(aml_chip->retry_stat));
+	aml_chip->retry_cache_dirty = 0;
+	if (aml_chip->aml_nandrrt_info->valid
+		&& aml_nand_ext_read_rsv_info(&aml_chip->mtd,
+			aml_chip->aml_nandrrt_info, 0,
+			(u_char *)&aml_chip->retry_cache))
+		memset(&aml_chip->retry_cache, 0,
+			sizeof(aml_chip->retry_cache));
+	return 0;
+}
+#endif /* NEW_NAND_SUPPORT */
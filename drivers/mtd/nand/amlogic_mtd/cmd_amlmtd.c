@@ -525,6 +525,38 @@ static int do_key_ops(cmd_tbl_t *cmdtp, int flag, int argc, char *const argv[])
 	return ret;
 }
 
+#ifdef NEW_NAND_SUPPORT
+/*
+ * operations for the learnt read retry levels.
+ */
+extern void amlnf_rrt_info(void);
+extern int amlnf_rrt_save(void);
+extern int amlnf_rrt_erase(void);
+static int do_rrt_ops(cmd_tbl_t *cmdtp, int flag, int argc, char *const argv[])
+{
+	int ret = 0;
+	char *sub = NULL;
+
+	if (strlen(argv[1]) > 3)
+		sub = &argv[1][4];
+	else if (argc > 2)
+		sub = argv[2];
+
+	if (!sub || !strcmp("info", sub)) {
+		amlnf_rrt_info();
+	} else if (!strcmp("save", sub)) {
+		ret = amlnf_rrt_save();
+		printk("%s() save %s\n", __func__, ret ? "Fail" : "Okay");
+	} else if (!strcmp("erase", sub)) {
+		ret = amlnf_rrt_erase();
+		printk("%s() erase %s\n", __func__, ret ? "Fail" : "Okay");
+	} else
+		return CMD_RET_USAGE;
+
+	return ret;
+}
+#endif
+
 static cmd_tbl_t cmd_amlmtd_sub[] = {
     U_BOOT_CMD_MKENT(rom, 5, 0, do_rom_ops, "", ""),
 #ifdef CONFIG_DISCRETE_BOOTLOADER
@@ -533,6 +565,9 @@ static cmd_tbl_t cmd_amlmtd_sub[] = {
 #endif
     U_BOOT_CMD_MKENT(dtb, 5, 0, do_dtb_ops, "", ""),
     U_BOOT_CMD_MKENT(key, 5, 0, do_key_ops, "", ""),
+#ifdef NEW_NAND_SUPPORT
+    U_BOOT_CMD_MKENT(rrt, 5, 0, do_rrt_ops, "", ""),
+#endif
 };
 
 static int do_amlmtd(cmd_tbl_t *cmdtp, int flag, int argc, char *const argv[])
@@ -590,6 +625,11 @@ static char amlmtd_help_text[] =
     "amlnf dtb_erase    - erase dtb area!\n"
     "amlnf key_read/write addr size	- read/write keys.\n"
     "amlnf key_erase    - erase keys!\n"
+#ifdef NEW_NAND_SUPPORT
+    "amlnf rrt_info     - show read retry counters and learnt levels\n"
+    "amlnf rrt_save     - save the learnt read retry levels\n"
+    "amlnf rrt_erase    - forget the learnt read retry levels\n"
+#endif
 	"";
 #endif
 U_BOOT_CMD(
@@ -895,6 +895,9 @@ static int m3_nand_probe(struct aml_nand_platform *plat, unsigned dev_num)
 		aml_ubootenv_init(aml_chip);
 		aml_key_init(aml_chip);
 		amlnf_dtb_init(aml_chip);
+#ifdef NEW_NAND_SUPPORT
+		aml_rrt_init(aml_chip);
+#endif
 	}
 
 	/*need to set device_boot_flag here*/
@@ -1478,7 +1478,7 @@ static struct aml_nand_flash_dev *aml_nand_get_flash_type(struct mtd_info *mtd,
 	memset(nand_info, 0, sizeof(struct new_tech_nand_t));
 	if (!strncmp((char*)type->id, (char*) dev_id_hynix_26nm_8g,
 		strlen((const char*)aml_nand_flash_ids[i].id))) {
-		nand_info.type = HYNIX_26NM_8GB;
+		nand_info->type = HYNIX_26NM_8GB;
 		aml_chip->ran_mode = 1;
 		printk("aml_chip->hynix_new_nand_type =: %d \n",
 			nand_info->type);
@@ -65,6 +65,7 @@ struct rsv_info {
 #define KEY_INFO_INDEX		2
 #define DTB_INFO_INDEX		3
 #define DDR_INFO_INDEX		4
+#define RRT_INFO_INDEX		5
 
 #define INFO_DATA(n, b, s)	{ .name = (n), .blocks = (b), .size = (s) }
 
@@ -76,6 +77,10 @@ static struct rsv_info info[] = {
 	INFO_DATA(KEY_NAND_MAGIC, NAND_KEY_BLOCK_NUM, 0),
 	INFO_DATA(DTB_NAND_MAGIC, NAND_DTB_BLOCK_NUM, 0),
 	INFO_DATA(DDR_NAND_MAGIC, NAND_DDR_BLOCK_NUM, 2048),
+#ifdef NEW_NAND_SUPPORT
+	INFO_DATA(RRT_NAND_MAGIC, NAND_RRT_BLOCK_NUM,
+		  sizeof(struct aml_nand_retry_cache)),
+#endif
 };
 
 static struct free_node_t *get_free_node(struct mtd_info *mtd)
@@ -849,6 +854,9 @@ static void aml_nand_rsv_info_ptr_fill(struct mtd_info *mtd)
 	aml_chip->aml_nandkey_info = &info[KEY_INFO_INDEX + subtract].rsv_info;
 	aml_chip->aml_nanddtb_info = &info[DTB_INFO_INDEX + subtract].rsv_info;
 	aml_chip->aml_nandddr_info = &info[DDR_INFO_INDEX + subtract].rsv_info;
+#ifdef NEW_NAND_SUPPORT
+	aml_chip->aml_nandrrt_info = &info[RRT_INFO_INDEX + subtract].rsv_info;
+#endif
 }
 
 static int aml_nand_rsv_info_alloc_init(struct mtd_info *mtd,
@@ -940,6 +948,9 @@ int aml_nand_rsv_info_init(struct mtd_info *mtd)
 	printk("key_start=%d ", aml_chip->aml_nandkey_info->start_block);
 	printk("dtb_start=%d ", aml_chip->aml_nanddtb_info->start_block);
 	printk("ddr_start=%d ", aml_chip->aml_nandddr_info->start_block);
+#ifdef NEW_NAND_SUPPORT
+	printk("rrt_start=%d ", aml_chip->aml_nandrrt_info->start_block);
+#endif
 	printk("\n");
 
 	return 0;
@@ -14,6 +14,8 @@
 #include <spi.h>
 #include <spi_flash.h>
 #include <watchdog.h>
+#include <asm/io.h>
+#include <asm/unaligned.h>
 
 #include "sf_internal.h"
 
@@ -360,6 +362,29 @@ int spi_flash_read_common(struct spi_flash *flash, const u8 *cmd,
 	return ret;
 }
 
+/*
+ * The window may be mapped as device memory, which only takes aligned
+ * accesses, so do not leave the copy to memcpy().
+ */
+static void spi_flash_mmap_read(void *data, const void *map, size_t len)
+{
+	const u8 *src = map;
+	u8 *dst = data;
+
+	while (len && ((uintptr_t)src & 3)) {
+		*dst++ = __raw_readb(src++);
+		len--;
+	}
+	while (len >= 4) {
+		put_unaligned(__raw_readl(src), (u32 *)dst);
+		src += 4;
+		dst += 4;
+		len -= 4;
+	}
+	while (len--)
+		*dst++ = __raw_readb(src++);
+}
+
 int spi_flash_cmd_read_ops(struct spi_flash *flash, u32 offset,
 		size_t len, void *data)
 {
@@ -368,15 +393,25 @@ int spi_flash_cmd_read_ops(struct spi_flash *flash, u32 offset,
 	int bank_sel = 0;
 	int ret = -1;
 
-	/* Handle memory-mapped SPI */
-	if (flash->memory_map) {
+	/* Handle memory-mapped SPI, the window has 3 address bytes */
+	if (flash->memory_map &&
+	    (offset + len <= (SPI_FLASH_16MB_BOUN << flash->shift))) {
+#ifdef CONFIG_SPI_FLASH_BAR
+		ret = spi_flash_bank(flash, 0);
+		if (ret < 0)
+			return ret;
+#endif
 		ret = spi_claim_bus(flash->spi);
 		if (ret) {
 			debug("SF: unable to claim SPI bus\n");
 			return ret;
 		}
-		spi_xfer(flash->spi, 0, NULL, NULL, SPI_XFER_MMAP);
-		memcpy(data, flash->memory_map + offset, len);
+		ret = spi_xfer(flash->spi, 0, NULL, NULL, SPI_XFER_MMAP);
+		if (ret) {
+			spi_release_bus(flash->spi);
+			return ret;
+		}
+		spi_flash_mmap_read(data, flash->memory_map + offset, len);
 		spi_xfer(flash->spi, 0, NULL, NULL, SPI_XFER_MMAP_END);
 		spi_release_bus(flash->spi);
 		return 0;
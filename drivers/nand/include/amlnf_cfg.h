@@ -33,6 +33,8 @@ Description:
 #define	AML_NAND_DBG				(0)
 #define	AML_CFG_INSIDE_PARTTBL		(0)
 #define AML_CFG_2PLANE_READ_EN		(1)
+/* sequential slc page reads with read cache (31h/3Fh) */
+#define AML_CFG_CACHE_READ_EN		(1)
 /* support nand with readretry&e-slc */
 #define	AML_CFG_NEW_NAND_SUPPORT	(1)
 /* new oob mode */
@@ -379,6 +379,8 @@ union nand_core_clk_t {
 #define	NAND_CMD_SET_FEATURES		0xEF
 #define	NAND_CMD_GET_FEATURES		0xEE
 #define	NAND_CMD_READSTART		0x30
+#define	NAND_CMD_READCACHESEQ		0x31
+#define	NAND_CMD_READCACHEEND		0x3f
 #define	NAND_CMD_RNDOUTSTART		0xE0
 #define	NAND_CMD_CACHEDPROG		0x15
 
@@ -675,6 +677,10 @@ struct chip_operation {
 	int (*test_block_reserved)(struct amlnand_chip *aml_chip, int tst_blk);
 	/***basic data operation and included oob data****/
 	int (*read_page)(struct amlnand_chip *aml_chip);
+#if (AML_CFG_CACHE_READ_EN)
+	/* sequential pages of one block, returns the pages read */
+	int (*read_page_cache)(struct amlnand_chip *aml_chip, u32 pages);
+#endif
 	int (*write_page)(struct amlnand_chip *aml_chip);
 
 	int (*block_isbad)(struct amlnand_chip *aml_chip);
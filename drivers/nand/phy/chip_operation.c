@@ -1017,6 +1017,141 @@ error_exit0:
 	return ret;
 }
 
+#if (AML_CFG_CACHE_READ_EN)
+/************************************************************
+ * read_page_cache, read @pages sequential pages of one block
+ * from ops_para->page_addr to ops_para->data_buf with the
+ * read cache sequential command. 31h moves the page into the
+ * cache register and starts the array read of the next page
+ * into the data register, so tR of the next page overlaps the
+ * dma and hw ecc of the current one; 3Fh ends it at the last.
+ * data only, hw ecc, single chip/plane, no slc/retry nand.
+ * return the pages read, the caller rereads the page it
+ * stopped at with read_page() which does the read retry.
+ *************************************************************/
+static int read_page_cache(struct amlnand_chip *aml_chip, u32 pages)
+{
+	struct hw_controller *controller = &(aml_chip->controller);
+	struct chip_ops_para *ops_para = &(aml_chip->ops_para);
+	u8 *buf = ops_para->data_buf;
+	u8 chipnr = ops_para->chipnr;
+	u32 page_addr, page_size, user_byte_num, i;
+	int ret;
+
+	if (!buf || ops_para->oob_buf
+		|| (ops_para->option & (DEV_SLC_MODE | DEV_MULTI_CHIP_MODE
+			| DEV_MULTI_PLANE_MODE | DEV_USE_SHAREPAGE_MODE
+			| DEV_ECC_SOFT_MODE))
+		|| (controller->bch_mode == NAND_ECC_NONE)
+		|| controller->oob_mod
+		|| (controller->flash_type != NAND_TYPE_SLC)
+		|| controller->retry_info.flag
+		|| (pages < 2))
+		return 0;
+
+	user_byte_num = controller->ecc_steps * controller->user_mode;
+	page_size = controller->ecc_steps * controller->ecc_unit;
+
+	page_addr = ops_para->page_addr;
+	if (unlikely(page_addr >= controller->internal_page_nums)) {
+		page_addr -= controller->internal_page_nums;
+		page_addr |= controller->internal_page_nums *
+			aml_chip->flash.internal_chipnr;
+	}
+
+	ret = controller->quene_rb(controller, chipnr);
+	if (ret) {
+		aml_nand_msg("quene rb busy here");
+		return ret;
+	}
+
+	controller->cmd_ctrl(controller, NAND_CMD_READ0, NAND_CTRL_CLE);
+	controller->cmd_ctrl(controller, 0x0, NAND_CTRL_ALE);
+	controller->cmd_ctrl(controller, 0x0, NAND_CTRL_ALE);
+	controller->cmd_ctrl(controller, page_addr, NAND_CTRL_ALE);
+	controller->cmd_ctrl(controller, page_addr>>8, NAND_CTRL_ALE);
+	controller->cmd_ctrl(controller, page_addr>>16, NAND_CTRL_ALE);
+	controller->cmd_ctrl(controller, NAND_CMD_READSTART, NAND_CTRL_CLE);
+	NFC_SEND_CMD_IDLE(controller, NAND_TWB_TIME_CYCLE);
+
+	for (i = 0; i < pages; i++) {
+		/* wait tR of page i into the data register */
+		ret = controller->quene_rb(controller, chipnr);
+		if (ret) {
+			aml_nand_msg("quene rb busy here");
+			return ret;
+		}
+		controller->cmd_ctrl(controller,
+			(i + 1 < pages) ? NAND_CMD_READCACHESEQ
+				: NAND_CMD_READCACHEEND,
+			NAND_CTRL_CLE);
+		NFC_SEND_CMD_IDLE(controller, NAND_TWB_TIME_CYCLE);
+		if (check_cmdfifo_size(controller)) {
+			aml_nand_msg("check cmdfifo size timeout");
+			BUG();
+		}
+		/* wait tRCBSY, page i is in the cache register then */
+		ret = controller->quene_rb(controller, chipnr);
+		if (ret) {
+			aml_nand_msg("quene rb busy here");
+			return ret;
+		}
+		if (controller->option & NAND_CTRL_NONE_RB) {
+			controller->cmd_ctrl(controller,
+				NAND_CMD_READ0, NAND_CTRL_CLE);
+			NFC_SEND_CMD_IDLE(controller, NAND_TWB_TIME_CYCLE);
+		}
+
+		/* transfer random seed. */
+		controller->page_addr = page_addr + i;
+		ret = controller->dma_read(controller,
+			page_size, controller->bch_mode);
+		if (ret) {
+			aml_nand_msg("dma error here");
+			BUG();
+			return ret;
+		}
+
+		controller->get_usr_byte(controller,
+			controller->oob_buf, user_byte_num);
+		ret = controller->hwecc_correct(controller,
+			page_size, controller->oob_buf);
+		if (ret == NAND_ECC_FAILURE) {
+			if (controller->zero_cnt >= controller->ecc_max) {
+				/* end the cache read, page i is reread */
+				if (i + 1 < pages) {
+					controller->quene_rb(controller, chipnr);
+					controller->cmd_ctrl(controller,
+						NAND_CMD_READCACHEEND,
+						NAND_CTRL_CLE);
+					NFC_SEND_CMD_IDLE(controller,
+						NAND_TWB_TIME_CYCLE);
+					controller->quene_rb(controller, chipnr);
+				}
+				break;
+			}
+			memset(buf, 0xff, page_size);
+		} else {
+			if ((controller->ecc_cnt_cur > controller->ecc_cnt_limit)
+				&& (aml_chip->flash.new_type == 0)) {
+				aml_nand_dbg("detect bitflip page:%d, chip:%d",
+					controller->page_addr, chipnr);
+				ops_para->bit_flip++;
+			}
+			memcpy(buf, controller->data_buf, page_size);
+		}
+		buf += page_size;
+	}
+
+	if (check_cmdfifo_size(controller)) {
+		aml_nand_msg("check cmdfifo size timeout");
+		BUG();
+	}
+
+	return i;
+}
+#endif /* AML_CFG_CACHE_READ_EN */
+
 /************************************************************
  * write_page, all parameters saved in aml_chip->ops_para.
  * support read way of hwecc/raw, data/oob only, data+oob
@@ -2925,6 +3060,11 @@ int amlnand_init_operation(struct amlnand_chip *aml_chip)
 	if (!operation->read_page)
 		operation->read_page = read_page;
 
+#if (AML_CFG_CACHE_READ_EN)
+	if (!operation->read_page_cache)
+		operation->read_page_cache = read_page_cache;
+#endif
+
 	if (!operation->write_page)
 		operation->write_page = write_page;
 
@@ -158,6 +158,9 @@ static int nand_read(struct amlnand_phydev *phydev)
 	struct chip_ops_para *ops_para = &(aml_chip->ops_para);
 	u64 addr, readlen = 0, len = 0;
 	int ret = 0;
+#if (AML_CFG_CACHE_READ_EN)
+	u32 pages;
+#endif
 
 	if ((devops->addr + devops->len) >  phydev->size) {
 		aml_nand_msg("out of space and addr:");
@@ -212,6 +215,34 @@ static int nand_read(struct amlnand_phydev *phydev)
 			ops_para->page_addr =
 				(int)(addr >> phydev->writesize_shift);
 
+#if (AML_CFG_CACHE_READ_EN)
+		/* the rest of this block with read cache */
+		pages = (phydev->erasesize -
+			((u32)addr & (phydev->erasesize - 1)))
+			>> phydev->writesize_shift;
+		if (pages > ((len - readlen + phydev->writesize - 1)
+			>> phydev->writesize_shift))
+			pages = (len - readlen + phydev->writesize - 1)
+				>> phydev->writesize_shift;
+		ret = operation->read_page_cache(aml_chip, pages);
+		if (ret < 0) {
+			aml_nand_msg("phy read failed at devops->addr: %llx",
+				devops->addr);
+			break;
+		}
+		if (ret > 0) {
+			addr += (u64)ret << phydev->writesize_shift;
+			ops_para->data_buf += ret << phydev->writesize_shift;
+			readlen += (u64)ret << phydev->writesize_shift;
+			if (readlen >= len) {
+				ret = 0;
+				break;
+			}
+			/* reread the page it stopped at below */
+			ops_para->page_addr =
+				(int)(addr >> phydev->writesize_shift);
+		}
+#endif
 		//aml_nand_msg("%s() page %x\n", __func__, ops_para->page_addr);
 		ret = operation->read_page(aml_chip);
 		if ((ops_para->ecc_err) || (ret < 0)) {
@@ -198,6 +198,45 @@ static void spifc_set_tx_op_mode(
 }
 
 
+#ifdef CONFIG_SPIFC_AHB_READ
+/*
+ * Memory mapped read: the controller issues the fast read itself for
+ * the AHB accesses to plat->mem_map, quad/dual i/o as the slave allows,
+ * and streams the data through its AHB buffer, no 64 bytes user cmd
+ * round trip per chunk. cs must be driven by the controller then.
+ */
+static void spifc_ahb_enable(
+		struct udevice *bus,
+		unsigned int slave_mode,
+		bool enable)
+{
+	struct spifc_platdata *plat = dev_get_platdata(bus);
+	struct spifc_priv *priv = dev_get_priv(bus);
+	struct spifc_regs *regs = priv->regs;
+	unsigned int val;
+
+	val = readl(&regs->ctrl);
+	val &= ~((1 << FAST_READ_DUAL_OUT) |
+			(1 << FAST_READ_QUAD_OUT) |
+			(1 << FAST_READ_DUAL_IO) |
+			(1 << FAST_READ_QUAD_IO) |
+			(1 << SPI_ENABLE_AHB));
+	if (enable) {
+		if (slave_mode & SPI_RX_QUAD)
+			val |= 1 << FAST_READ_QUAD_IO;
+		else if (slave_mode & SPI_RX_DUAL)
+			val |= 1 << FAST_READ_DUAL_IO;
+		val |= 1 << SPI_ENABLE_AHB;
+		/* the user cmds leave their bits in user */
+		writel(0, &regs->user);
+	}
+	if (plat->cs_hw_enable)
+		plat->cs_hw_enable(priv->pinctrl, enable);
+	writel(val, &regs->ctrl);
+	spifc_dbg("%s ahb read, ctrl=0x%x\n", enable ? "enable" : "disable", val);
+}
+#endif /* CONFIG_SPIFC_AHB_READ */
+
 static int spifc_user_cmd(
 	struct spifc_priv *priv,
 	u8 cmd, u8 *buf, u8 len)
@@ -447,6 +486,12 @@ static int spifc_xfer(
 	}
 	spifc_set_speed(bus, slave->max_hz);
 	spifc_set_mode(bus, slave->mode);
+#ifdef CONFIG_SPIFC_AHB_READ
+	if (flags & (SPI_XFER_MMAP | SPI_XFER_MMAP_END)) {
+		spifc_ahb_enable(bus, slave->mode, !!(flags & SPI_XFER_MMAP));
+		return 0;
+	}
+#endif
 	if (flags & SPI_XFER_BEGIN) {
 		spifc_chipselect(dev, 1);
 		buf = (u8 *)dout;
@@ -511,6 +556,19 @@ static int spifc_probe(struct udevice *bus)
 	return 0;
 }
 
+#ifdef CONFIG_SPIFC_AHB_READ
+static int spifc_child_pre_probe(struct udevice *dev)
+{
+	struct spifc_platdata *plat = dev_get_platdata(dev->parent);
+	struct spi_slave *slave = dev_get_parentdata(dev);
+
+	/* spi flash takes it as its read window */
+	if (plat->mem_map && plat->cs_hw_enable)
+		slave->memory_map = (void *)plat->mem_map;
+	return 0;
+}
+#endif
+
 #ifdef CONFIG_OF_CONTROL
 static int spifc_ofdata_to_platdata(struct udevice *bus)
 {
@@ -553,4 +611,7 @@ U_BOOT_DRIVER(spifc) = {
 	.per_child_auto_alloc_size = sizeof(struct spi_slave),
 	.ops= &spifc_ops,
 	.probe = spifc_probe,
+#ifdef CONFIG_SPIFC_AHB_READ
+	.child_pre_probe = spifc_child_pre_probe,
+#endif
 };
@@ -29,6 +29,7 @@
 
 #include <common.h>
 #include <linux/types.h>
+#include <malloc.h>
 #include <amlogic/secure_storage.h>
 #include <amlogic/storage_if.h>
 #include <amlogic/amlkey_if.h>
@@ -56,6 +57,73 @@ static struct storagekey_info_t storagekey_info = {
 	.status = KEYBUFFER_CLEAN,
 };
 
+/*
+ * every query of bl31 is an smc, and reads decrypt the key again.
+ * keep what was learnt about a key until it is written or removed.
+ */
+#define STORAGEKEY_CACHE_NUM	(32)
+
+struct storagekey_cache_t {
+	char name[AMLKEY_NAME_LEN_MAX];
+	uint32_t exist;
+	uint32_t attr;		/* valid if exist */
+	uint32_t size;		/* valid if exist */
+	uint8_t *data;		/* value of a non-secure key, once read */
+};
+
+static struct storagekey_cache_t storagekey_cache[STORAGEKEY_CACHE_NUM];
+
+static void storagekey_cache_drop(struct storagekey_cache_t *entry)
+{
+	free(entry->data);
+	memset(entry, 0, sizeof(*entry));
+}
+
+static void storagekey_cache_invalidate(const uint8_t *name)
+{
+	int i;
+
+	for (i = 0; i < STORAGEKEY_CACHE_NUM; i++) {
+		if (!storagekey_cache[i].name[0])
+			continue;
+		if (!name || !strcmp(storagekey_cache[i].name, (const char *)name))
+			storagekey_cache_drop(&storagekey_cache[i]);
+	}
+}
+
+/* entry of @name, queried from bl31 on first use. NULL if not cacheable */
+static struct storagekey_cache_t *storagekey_cache_get(const uint8_t *name)
+{
+	struct storagekey_cache_t *entry = NULL;
+	uint32_t retval;
+	int i;
+
+	if (strlen((const char *)name) >= AMLKEY_NAME_LEN_MAX)
+		return NULL;
+	for (i = 0; i < STORAGEKEY_CACHE_NUM; i++) {
+		if (!strcmp(storagekey_cache[i].name, (const char *)name))
+			return &storagekey_cache[i];
+		if (!entry && !storagekey_cache[i].name[0])
+			entry = &storagekey_cache[i];
+	}
+	if (!entry)
+		return NULL;
+
+	if (secure_storage_query((uint8_t *)name, &retval))
+		return NULL;
+	entry->exist = retval;
+	if (entry->exist) {
+		if (secure_storage_status((uint8_t *)name, &entry->attr)
+			|| secure_storage_tell((uint8_t *)name, &entry->size)) {
+			memset(entry, 0, sizeof(*entry));
+			return NULL;
+		}
+	}
+	strcpy(entry->name, (const char *)name);
+
+	return entry;
+}
+
 /**
  *1.init
  * return ok 0, fail 1
@@ -86,6 +154,7 @@ int32_t amlkey_init(uint8_t *seed, uint32_t len, int encrypt_type)
 	secure_storage_set_enctype(encrypt_type);
 
 	/* full fill key infos from storage. */
+	storagekey_cache_invalidate(NULL);
 	ret = store_key_read(storagekey_info.buffer,
 		storagekey_info.size,
 		&actual_size);
@@ -120,11 +189,15 @@ int32_t amlkey_isexsit(const uint8_t * name)
 {
 	int32_t ret = 0;
 	uint32_t retval;
+	struct storagekey_cache_t *entry;
 
 	if ( NULL == name ) {
 		printf("%s() %d, invalid key ", __func__, __LINE__);
 		return 0;
 	}
+	entry = storagekey_cache_get(name);
+	if (entry)
+		return (int32_t)entry->exist;
 
 	ret = secure_storage_query((uint8_t *)name, &retval);
 	if (ret) {
@@ -139,11 +212,15 @@ static int32_t amlkey_get_attr(const uint8_t * name)
 {
 	int32_t ret = 0;
 	uint32_t retval;
+	struct storagekey_cache_t *entry;
 
 	if ( NULL == name ) {
 		printf("%s() %d, invalid key ", __func__, __LINE__);
 		return 0;
 	}
+	entry = storagekey_cache_get(name);
+	if (entry && entry->exist)
+		return (int32_t)entry->attr;
 
 	ret = secure_storage_status((uint8_t *)name, &retval);
 	if (ret) {
@@ -180,11 +257,15 @@ ssize_t amlkey_size(const uint8_t *name)
 	ssize_t size = 0;
 	int32_t ret = 0;
 	uint32_t retval;
+	struct storagekey_cache_t *entry;
 
 	if ( NULL == name ) {
 		printf("%s() %d, invalid key ", __func__, __LINE__);
 		return 0;
 	}
+	entry = storagekey_cache_get(name);
+	if (entry && entry->exist)
+		return (ssize_t)entry->size;
 
 	ret = secure_storage_tell((uint8_t *)name, &retval);
 	if (ret) {
@@ -204,11 +285,29 @@ ssize_t amlkey_read(const uint8_t *name, uint8_t *buffer, uint32_t len)
 	int32_t ret = 0;
 	ssize_t retval = 0;
 	uint32_t actul_len;
+	struct storagekey_cache_t *entry;
 
 	if ( NULL == name ) {
 		printf("%s() %d, invalid key ", __func__, __LINE__);
 		return 0;
 	}
+	entry = storagekey_cache_get(name);
+	if (entry && entry->exist && entry->size && (len >= entry->size)
+		&& !(entry->attr & UNIFYKEY_ATTR_SECURE_MASK)) {
+		if (!entry->data) {
+			entry->data = malloc(entry->size);
+			if (entry->data && (secure_storage_read((uint8_t *)name,
+				entry->data, entry->size, &actul_len)
+				|| (actul_len != entry->size))) {
+				free(entry->data);
+				entry->data = NULL;
+			}
+		}
+		if (entry->data) {
+			memcpy(buffer, entry->data, entry->size);
+			return (ssize_t)entry->size;
+		}
+	}
 	ret = secure_storage_read((uint8_t *)name, buffer, len, &actul_len);
 	if (ret) {
 		printf("%s() %d: return %d\n", __func__, __LINE__, ret);
@@ -236,6 +335,7 @@ ssize_t amlkey_write(const uint8_t *name, uint8_t *buffer, uint32_t len, uint32_
 		printf("%s() %d, invalid key ", __func__, __LINE__);
 		return retval;
 	}
+	storagekey_cache_invalidate(name);
 	ret = secure_storage_write((uint8_t *)name, buffer, len, attr);
 	if (ret) {
 		printf("%s() %d: return %d\n", __func__, __LINE__, ret);
@@ -280,6 +380,7 @@ int32_t amlkey_del(const uint8_t * name)
 	int32_t ret = 0;
 	uint32_t actual_size;
 
+	storagekey_cache_invalidate(name);
 	ret = secure_storage_remove((uint8_t *)name);
 	if ((ret == 0) && (storagekey_info.buffer != NULL)) {
 		/* flush back */
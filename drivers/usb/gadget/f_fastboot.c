@@ -85,6 +85,32 @@ static struct f_fastboot *fastboot_func;
 static unsigned int download_size;
 static unsigned int download_bytes;
 
+#ifdef CONFIG_FASTBOOT_FLASH_STREAM
+/*
+ * 'oem stream <partition>' arms the streaming flash: the next download is
+ * written to the partition while it is received, so it is not limited by
+ * the download buffer, and the next 'flash' of that partition only reports
+ * the result. The stream is disarmed after that flash and by any download
+ * that is not streamed, so each transfer has to be armed again. 'oem stream
+ * off' disarms it.
+ */
+#ifndef CONFIG_FASTBOOT_FLASH_STREAM_CHUNK
+#define CONFIG_FASTBOOT_FLASH_STREAM_CHUNK	(16 << 20)
+#endif
+
+#define FB_STREAM_OFF		0
+#define FB_STREAM_ARMED		1
+#define FB_STREAM_RUNNING	2	/* download is being flashed */
+#define FB_STREAM_DONE		3	/* result waits for the flash command */
+
+static int stream_state;
+static int stream_failed;
+static char stream_part[32];
+static uint64_t stream_part_bytes;
+static unsigned int stream_fill;	/* bytes in buffer not flashed yet */
+static char stream_response[RESPONSE_LEN + 1];
+#endif
+
 
 static struct usb_endpoint_descriptor ep_in = {
 	.bLength            = USB_DT_ENDPOINT_SIZE,
@@ -654,6 +680,11 @@ static void cb_getvar(struct usb_ep *ep, struct usb_request *req)
 		char str_num[12];
 
 		sprintf(str_num, "0x%08x", ddr_size_usable(CONFIG_USB_FASTBOOT_BUF_ADDR));
+#ifdef CONFIG_FASTBOOT_FLASH_STREAM
+		if (stream_state == FB_STREAM_ARMED)
+			sprintf(str_num, "0x%08x", (unsigned int)min_t(uint64_t,
+				stream_part_bytes, 0xfffff000));
+#endif
 		strncat(response, str_num, chars_left);
 	} else if (!strcmp_l1("serialno", cmd)) {
 		//s = getenv("serial");
@@ -918,6 +949,38 @@ static unsigned int rx_bytes_expected(void)
 	return rx_remain;
 }
 
+#ifdef CONFIG_FASTBOOT_FLASH_STREAM
+/* flash the buffered download each CONFIG_FASTBOOT_FLASH_STREAM_CHUNK */
+static void fastboot_stream_rx(const unsigned char *buffer, unsigned int size,
+			       int is_last)
+{
+	void *buf = (void *)CONFIG_USB_FASTBOOT_BUF_ADDR;
+	unsigned int used = 0;
+
+	if (stream_failed)
+		return;	/* drain the download, the error is replied at end */
+
+	memcpy(buf + stream_fill, buffer, size);
+	stream_fill += size;
+	if (stream_fill < CONFIG_FASTBOOT_FLASH_STREAM_CHUNK && !is_last)
+		return;
+
+	if (fb_mmc_stream_write(buf, stream_fill, is_last, &used)) {
+		stream_failed = 1;
+		strncpy(stream_response, response_str, RESPONSE_LEN);
+		return;
+	}
+	stream_fill -= used;
+	memmove(buf, buf + used, stream_fill);
+
+	if (is_last) {
+		fb_mmc_stream_end();
+		strncpy(stream_response, response_str, RESPONSE_LEN);
+		stream_failed = strncmp(stream_response, "OKAY", 4);
+	}
+}
+#endif
+
 #define BYTES_PER_DOT	0x20000
 static void rx_handler_dl_image(struct usb_ep *ep, struct usb_request *req)
 {
@@ -935,6 +998,12 @@ static void rx_handler_dl_image(struct usb_ep *ep, struct usb_request *req)
 	if (buffer_size < transfer_size)
 		transfer_size = buffer_size;
 
+#ifdef CONFIG_FASTBOOT_FLASH_STREAM
+	if (stream_state == FB_STREAM_RUNNING)
+		fastboot_stream_rx(buffer, transfer_size,
+				   download_bytes + transfer_size >= download_size);
+	else
+#endif
 	memcpy((void *)CONFIG_USB_FASTBOOT_BUF_ADDR + download_bytes,
 	       buffer, transfer_size);
 
@@ -959,6 +1028,13 @@ static void rx_handler_dl_image(struct usb_ep *ep, struct usb_request *req)
 		req->length = EP_BUFFER_SIZE;
 
 		sprintf(response, "OKAY");
+#ifdef CONFIG_FASTBOOT_FLASH_STREAM
+		if (stream_state == FB_STREAM_RUNNING) {
+			stream_state = FB_STREAM_DONE;
+			if (stream_failed)
+				strcpy(response, stream_response);
+		}
+#endif
 		fastboot_tx_write_str(response);
 
 		printf("\ndownloading of %d bytes finished\n", download_bytes);
@@ -985,6 +1061,33 @@ static void cb_download(struct usb_ep *ep, struct usb_request *req)
 
 	printf("Starting download of %d bytes\n", download_size);
 
+#ifdef CONFIG_FASTBOOT_FLASH_STREAM
+	if (stream_state != FB_STREAM_ARMED || !download_size) {
+		/* not armed, or a streamed download whose flash never came */
+		stream_state = FB_STREAM_OFF;
+	} else {
+		stream_state = FB_STREAM_OFF;
+		stream_fill = 0;
+		stream_failed = 0;
+		if (download_size > stream_part_bytes) {
+			download_size = 0;
+			sprintf(response, "FAILdata too large");
+		} else if (fb_mmc_stream_start(stream_part, &stream_part_bytes)) {
+			download_size = 0;
+			sprintf(response, "FAILstream to %s failed", stream_part);
+		} else {
+			stream_state = FB_STREAM_RUNNING;
+			sprintf(response, "DATA%08x", download_size);
+			req->complete = rx_handler_dl_image;
+			req->length = rx_bytes_expected();
+			if (req->length < ep->maxpacket)
+				req->length = ep->maxpacket;
+		}
+		fastboot_tx_write_str(response);
+		return;
+	}
+#endif
+
 	if (0 == download_size) {
 		sprintf(response, "FAILdata invalid size");
 	} else if (download_size > ddr_size_usable(CONFIG_USB_FASTBOOT_BUF_ADDR)) {
@@ -1239,6 +1342,18 @@ static void cb_flash(struct usb_ep *ep, struct usb_request *req)
 		printf("partition is %s\n", cmd);
 	}
 
+#ifdef CONFIG_FASTBOOT_FLASH_STREAM
+	/* the image is already flashed while downloading */
+	if (stream_state == FB_STREAM_DONE) {
+		stream_state = FB_STREAM_OFF;
+		if (strcmp(cmd, stream_part))
+			fastboot_tx_write_str("FAILimage was streamed to another partition");
+		else
+			fastboot_tx_write_str(stream_response);
+		return;
+	}
+#endif
+
 	//strcpy(response, "FAILno flash device defined");
 	if (is_mainstorage_emmc()) {
 #ifdef CONFIG_FASTBOOT_FLASH_MMC_DEV
@@ -1385,6 +1500,49 @@ static void cb_devices(struct usb_ep *ep, struct usb_request *req)
 	fastboot_tx_write_str(response);
 }
 
+#ifdef CONFIG_FASTBOOT_FLASH_STREAM
+/* oem stream <partition> | off */
+static void cb_oem_stream(char *cmd)
+{
+	strsep(&cmd, " ");
+	if (!cmd || !*cmd) {
+		fastboot_tx_write_str("FAILmissing partition name");
+		return;
+	}
+	if (!strcmp(cmd, "off")) {
+		stream_state = FB_STREAM_OFF;
+		fastboot_tx_write_str("OKAY");
+		return;
+	}
+	if (check_lock()) {
+		fastboot_tx_write_str("FAILlocked device");
+		return;
+	}
+#ifdef CONFIG_BOOTLOADER_CONTROL_BLOCK
+	if (dynamic_partition && is_partition_logical(cmd) == 0) {
+		fastboot_tx_write_str("FAILlogic partition");
+		return;
+	}
+#endif
+	if (!is_mainstorage_emmc()) {
+		fastboot_tx_write_str("FAILstream only supports emmc");
+		return;
+	}
+
+	strncpy(stream_part, strcmp(cmd, "userdata") ? cmd : "data",
+		sizeof(stream_part) - 1);
+	stream_part[sizeof(stream_part) - 1] = 0;
+	if (fb_mmc_stream_start(stream_part, &stream_part_bytes)) {
+		stream_state = FB_STREAM_OFF;
+		fastboot_tx_write_str("FAILpartition can't be streamed");
+		return;
+	}
+	stream_state = FB_STREAM_ARMED;
+	FB_MSG("stream flash to %s armed, max 0x%llx\n", stream_part, stream_part_bytes);
+	fastboot_tx_write_str("OKAY");
+}
+#endif
+
 static void cb_oem_cmd(struct usb_ep *ep, struct usb_request *req)
 {
 	char response[RESPONSE_LEN/2 + 1];
@@ -1395,6 +1553,12 @@ static void cb_oem_cmd(struct usb_ep *ep, struct usb_request *req)
 	memcpy(response, cmd, strnlen(cmd, RESPONSE_LEN/2)+1);//+1 to terminate str
 	cmd = response;
 	strsep(&cmd, " ");
+#ifdef CONFIG_FASTBOOT_FLASH_STREAM
+	if (cmd && !strncmp(cmd, "stream", strlen("stream"))) {
+		cb_oem_stream(cmd);
+		return;
+	}
+#endif
 	FB_MSG("To run cmd[%s]\n", cmd);
 	run_command(cmd, 0);
 
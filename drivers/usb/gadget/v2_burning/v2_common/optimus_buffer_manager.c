@@ -50,9 +50,16 @@ typedef struct bufManager{
     u32             partBaseOffset;//TODO: change it to memory address when dest media type is memory
     u32             itemOffsetNotAlignClusterSz_f;//For sdcard burning, item offset of aml_upgrade_package.img is not aligned to bytespercluster of FAT fs(_f means not changed inited)
 
+    u32             ringSz;//transfer buffer wraps at ringSz, n * writeBackUnitSz
+    s16             isAsyncWriteBack;//1 if write back of a unit is deferred until usb idle, only for usb burning
+    s16             pendingErr;//error of deferred write back, reported at next transfer
+    const u8*       pendingData;//data of the deferred write back unit not written yet
+    u32             pendingSz;
+
 }BufManager;
 
-//TODO: if want to speed-up such as soft PING-PONG buffer, use multiple BufManager
+//The transfer buffer is a ring of write back units: when usb burning, a full unit is written back in slices
+//between usb polling, while usb receives the next unit, see optimus_buf_manager_write_back_pending
 static BufManager _bufManager =
 {
 //constant members
@@ -74,6 +81,10 @@ static BufManager _bufManager =
     .pktTransferSta     = PKT_TRANSFER_STA_EMPTY,
 
     .itemOffsetNotAlignClusterSz_f  = 0,
+
+    .ringSz             = OPTIMUS_DOWNLOAD_SLOT_SZ,
+    .isAsyncWriteBack   = 0,
+    .pendingSz          = 0,
 };
 
 int optimus_buf_manager_init(const unsigned mediaAlignSz)
@@ -154,6 +165,20 @@ int optimus_buf_manager_tplcmd_init(const char* mediaType,  const char* partName
     }
     DWN_DBG("writeBackUnitSz = 0x%x, pktSz4BufManager = %lld\n", writeBackUnitSz, pktSz4BufManager);
 
+    //usb burning to store: a ring of (at least 2) write back units, so usb receiving overlaps media writing
+    _bufManager.isAsyncWriteBack    = 0;
+    if (!isUpload && !cacheAll2Mem && !itemSizeNotAligned
+            && OPTIMUS_MEDIA_TYPE_STORE == _bufManager.destMediaType
+            && (OPTIMUS_WORK_MODE_USB_UPDATE == optimus_work_mode_get() || OPTIMUS_WORK_MODE_USB_PRODUCE == optimus_work_mode_get()))
+    {
+        if (OPTIMUS_SIMG_WRITE_BACK_SZ == writeBackUnitSz) writeBackUnitSz = OPTIMUS_SIMG_RING_WRITE_BACK_SZ;
+        _bufManager.isAsyncWriteBack = !(_bufManager.transferBufSz % writeBackUnitSz) && _bufManager.transferBufSz > writeBackUnitSz;
+    }
+    _bufManager.ringSz              = _bufManager.isAsyncWriteBack ? _bufManager.transferBufSz : writeBackUnitSz;
+    _bufManager.pendingErr          = 0;
+    _bufManager.pendingData         = NULL;
+    _bufManager.pendingSz           = 0;//drop unit deferred by an aborted download
+
     _bufManager.writeBackUnitSz     = writeBackUnitSz;
     _bufManager.totalSlotNum        = 0;
     _bufManager.isUpload            = isUpload;
@@ -181,20 +206,118 @@ int optimus_buf_manager_tplcmd_init(const char* mediaType,  const char* partName
     _bufManager.tplcmdTotalSz               = pktSz4BufManager;
 
     optimus_progress_init((u32)(_bufManager.tplcmdTotalSz>>32), (u32)_bufManager.tplcmdTotalSz, 0, 100);
-    DWN_MSG("totalSlotNum = %d, nextWriteBackSlot %d\n", _bufManager.totalSlotNum, _bufManager.nextWriteBackSlot);
+    DWN_MSG("totalSlotNum = %d, nextWriteBackSlot %d, async %d\n", _bufManager.totalSlotNum, _bufManager.nextWriteBackSlot, _bufManager.isAsyncWriteBack);
+
+    return OPT_DOWN_OK;
+}
+
+#define _BUF_MANAGER_BASE() ((OPTIMUS_MEDIA_TYPE_MEM != _bufManager.destMediaType)  ? _bufManager.transferBuf : \
+                        (u8*)(u64)_bufManager.partBaseOffset)
+
+//write back [wrData, wrData + wrSz) and the data left in previous write back before wrData
+//data not disposed by media this time is left just before the next data, or moved to the back buf if the ring wraps
+static int _buf_manager_write_back(const u8* wrData, const u32 wrSz, const unsigned reserveNotAlignSz, const int isPktEnd, char* errInfo)
+{
+    const u8* BufBase = _BUF_MANAGER_BASE();
+    u32   burnSz   = 0;
+    u32   leftSz   = _bufManager.leftDataSz;//data size not write to media in previous write back, > 0 only when not normal packet
+    const u32 size = leftSz + wrSz;
+    const u8* data = wrData -leftSz;
+    unsigned long tick = 0;
+
+    //itemOffsetNotAlignClusterSz_f is from sdcard/usb local package
+    //emmc write need align cluster to make next write offset align clusterm
+    DWN_DBG("size 0x%x, reserveNotAlignSz 0x%x\n", size, reserveNotAlignSz);
+#if CONFIG_AML_LOCAL_BURN_BUFF_NOT_ALIGN
+    //As aml_upgrade_package.img is aligned 4,so data from pkg may not align 8 in sdc/usb disk burn case
+    //data not align will invoke emmc write error (may dma issue ?)
+    //Need Macro as newer chip family such as u200 has not this failure
+    if ((uint64_t)data & 0x7) {
+        DWN_MSG("data %p not align 64bit\n", data);
+        u8* alignBuf = (u8*)(((uint64_t)data>>3) << 3);
+        memmove(alignBuf, data, size);
+        data = alignBuf;
+    }
+#endif//#if CONFIG_AML_LOCAL_BURN_BUFF_NOT_ALIGN
+    tick = timer_get_us();
+    burnSz = optimus_download_img_data(data, size - reserveNotAlignSz, errInfo);
+    optimus_progress_media_write_stat(burnSz, timer_get_us() - tick);
+    if (burnSz <= leftSz || !burnSz) {
+        DWN_ERR("this burn size %d <= last left size %d, data 0x%p\n", burnSz, leftSz, data);
+        return OPT_DOWN_FAIL;
+    }
+    if (size - reserveNotAlignSz < burnSz) {
+        DWN_ERR("Exception:siz 0x%x < burnSz 0x%x\n", size - reserveNotAlignSz, burnSz);
+        return OPT_DOWN_FAIL;
+    }
+
+    leftSz = size - burnSz;
+    if (leftSz)
+    {
+        const u8* src = data + burnSz;
+        const int isRingEnd = (wrData + wrSz == BufBase + _bufManager.ringSz);
+        u8* dest = (u8*)(isRingEnd ? BufBase : wrData + wrSz) - leftSz;
+
+        if (isPktEnd) {
+            DWN_ERR("Exception:packet end but data left 0x%x, cmd sz 0x%llx!\n", leftSz, _bufManager.tplcmdTotalSz);
+            return OPT_DOWN_FAIL;
+        }
+
+        if (leftSz > OPTIMUS_SPARSE_IMG_LEFT_DATA_MAX_SZ) {
+            DWN_ERR("Exception, left data sz 0x%x > back buf sz 0x%x!\n", leftSz, OPTIMUS_SPARSE_IMG_LEFT_DATA_MAX_SZ);
+            return OPT_DOWN_FAIL;
+        }
+        if (leftSz & 0x03) {
+            DWN_ERR("Exception, copy size not align to 4! May will copy fail!\n");
+            return OPT_DOWN_FAIL;
+        }
+
+        DWN_DBG("MV:left size 0x%08x, src %p, dest %p\n", leftSz, src, dest);
+        if (dest != src) memmove(dest, src, leftSz);
+    }
 
+    _bufManager.leftDataSz = leftSz;
     return OPT_DOWN_OK;
 }
 
+//write back one slice of the deferred unit, return non-zero if media error
+int optimus_buf_manager_write_back_pending(void)
+{
+    static char _pendingErrInfo[256];
+    const u32 thisWriteSz = min(_bufManager.pendingSz, (u32)OPTIMUS_ASYNC_WRITE_BACK_SLICE_SZ);
+    int ret = 0;
+
+    if (!thisWriteSz) return 0;
+
+    ret = _buf_manager_write_back(_bufManager.pendingData, thisWriteSz, 0, 0, _pendingErrInfo);
+    if (ret) {
+        DWN_ERR("Fail in deferred write back, left 0x%x\n", _bufManager.pendingSz);
+        _bufManager.pendingErr = ret;
+        _bufManager.pendingSz  = 0;
+        return ret;
+    }
+    _bufManager.pendingData += thisWriteSz;
+    _bufManager.pendingSz   -= thisWriteSz;
+
+    return 0;
+}
+
+static int _buf_manager_write_back_all_pending(void)
+{
+    while (_bufManager.pendingSz && !_bufManager.pendingErr)
+        optimus_buf_manager_write_back_pending();
+
+    return _bufManager.pendingErr;
+}
+
 int optimus_buf_manager_get_buf_for_bulk_transfer(char** pBuf, const unsigned wantSz, const unsigned sequenceNo, char* errInfo)
 {
     const unsigned totalSlotNum      = _bufManager.totalSlotNum;
     const u64 totalTransferSz        = ((u64)totalSlotNum) * _bufManager.transferUnitSz;//data size already transferred
     const u64 leftPktSz              = (totalTransferSz > _bufManager.tplcmdTotalSz) ? 0 :(_bufManager.tplcmdTotalSz - totalTransferSz);
     const int isLastTransfer         = (leftPktSz == wantSz);//totalTransferSz + wantSz >= _bufManager.tplcmdTotalSz;
-    const u32 bufSzNotDisposed       = ((u32)totalTransferSz)% _bufManager.writeBackUnitSz;//buffer data not disposed, bufSz is always writeBackUnitSz
-    const u8* BufBase = (OPTIMUS_MEDIA_TYPE_MEM != _bufManager.destMediaType)  ? _bufManager.transferBuf :
-                        (u8*)(u64)_bufManager.partBaseOffset ;
+    const u32 bufSzNotDisposed       = ((u32)totalTransferSz)% _bufManager.ringSz;//buffer data not disposed, bufSz is always writeBackUnitSz
+    const u8* BufBase = _BUF_MANAGER_BASE();
 
     if (wantSz < _bufManager.transferUnitSz && !isLastTransfer) {
         DWN_ERR("only last transfer can less 64K, this index %d at size 0x%u illegle\n", totalSlotNum + 1, wantSz);
@@ -210,6 +333,18 @@ int optimus_buf_manager_get_buf_for_bulk_transfer(char** pBuf, const unsigned wa
     DWN_DBG("bufSzNotDisposed 0x%x, _bufManager.transferBuf 0x%p, _bufManager.partBaseOffset 0x%x, *pBuf 0x%p\n",
             bufSzNotDisposed, _bufManager.transferBuf, _bufManager.partBaseOffset, *pBuf);
 
+    //never receive into data of the deferred unit (including its left data) not written yet
+    if (_bufManager.pendingSz)
+    {
+        const u8* pendingStart  = _bufManager.pendingData - _bufManager.leftDataSz;
+        const u8* pendingEnd    = _bufManager.pendingData + _bufManager.pendingSz;
+
+        if ((u8*)*pBuf < pendingEnd && (u8*)*pBuf + wantSz > pendingStart) {
+            DWN_DBG("wait deferred write back 0x%x\n", _bufManager.pendingSz);
+            if (_buf_manager_write_back_all_pending()) return OPT_DOWN_FAIL;
+        }
+    }
+
     _bufManager.pktTransferSta      = PKT_TRANSFER_STA_WORKING;
 
     //prepare data for upload
@@ -233,72 +368,41 @@ int optimus_buf_manager_report_transfer_complete(const u32 transferSz, char* err
     const unsigned totalSlotNum      = _bufManager.totalSlotNum;
     const u64 totalTransferSz        = ((u64)totalSlotNum) * _bufManager.transferUnitSz + transferSz;
     const u64 leftPktSz              = (totalTransferSz > _bufManager.tplcmdTotalSz) ? 0 :(_bufManager.tplcmdTotalSz - totalTransferSz);
-    const u32 thisWriteBackSz        = (_bufManager.transferUnitSz == transferSz) ? _bufManager.writeBackUnitSz : ((u32)totalTransferSz % _bufManager.writeBackUnitSz);
-    const u8* BufBase = (OPTIMUS_MEDIA_TYPE_MEM != _bufManager.destMediaType)  ? _bufManager.transferBuf :
-                        (u8*)(u64)_bufManager.partBaseOffset ;
+    const u32 thisWriteBackSz        = ((u32)(totalTransferSz - 1) % _bufManager.writeBackUnitSz) + 1;//data size from start of this write back unit
+    const u8* BufBase = _BUF_MANAGER_BASE();
 
     DWN_DBG("transferSz=0x%x\n", transferSz);
+    if (_bufManager.pendingErr) {//error in deferred write back of previous unit
+        DWN_ERR("deferred write back failed %d\n", _bufManager.pendingErr);
+        return _bufManager.pendingErr;
+    }
+
     //state fileds to update
     _bufManager.totalSlotNum += 1;
     if (_bufManager.totalSlotNum == _bufManager.nextWriteBackSlot)
     {
-        u32   burnSz   = 0;
-        u32   leftSz   = _bufManager.leftDataSz;//data size not write to media in previous write back, > 0 only when not normal packet
-        const u32 size = leftSz + thisWriteBackSz;
-        const u8* data = (u8*)BufBase -leftSz;
+        const u32 unitOffset = ((u32)(totalTransferSz - thisWriteBackSz)) % _bufManager.ringSz;
+        const u8* unitData   = BufBase + unitOffset;
         const unsigned reserveNotAlignSz = leftPktSz ? _bufManager.itemOffsetNotAlignClusterSz_f : 0;//reserve
 
-        //itemOffsetNotAlignClusterSz_f is from sdcard/usb local package
-        //emmc write need align cluster to make next write offset align clusterm
-        DWN_DBG("size 0x%x, reserveNotAlignSz 0x%x\n", size, reserveNotAlignSz);
-#if CONFIG_AML_LOCAL_BURN_BUFF_NOT_ALIGN
-        //As aml_upgrade_package.img is aligned 4,so data from pkg may not align 8 in sdc/usb disk burn case
-        //data not align will invoke emmc write error (may dma issue ?)
-        //Need Macro as newer chip family such as u200 has not this failure
-        if ((uint64_t)data & 0x7) {
-            DWN_MSG("data %p not align 64bit\n", data);
-            u8* alignBuf = (u8*)(((uint64_t)data>>3) << 3);
-            memmove(alignBuf, data, size);
-            data = alignBuf;
-        }
-#endif//#if CONFIG_AML_LOCAL_BURN_BUFF_NOT_ALIGN
-        burnSz = optimus_download_img_data(data, size - reserveNotAlignSz, errInfo);
-        if (burnSz <= leftSz || !burnSz) {
-            DWN_ERR("this burn size %d <= last left size %d, data 0x%p\n", burnSz, leftSz, data);
-            return OPT_DOWN_FAIL;
-        }
-        if (size - reserveNotAlignSz < burnSz) {
-            DWN_ERR("Exception:siz 0x%x < burnSz 0x%x\n", size - reserveNotAlignSz, burnSz);
+        //only one unit deferred, the one before must be on media when this one starts
+        if (_buf_manager_write_back_all_pending()) {
+            if (errInfo) sprintf(errInfo, "Fail in deferred write back\n");
             return OPT_DOWN_FAIL;
         }
 
-        leftSz = size - burnSz;
-        if (leftSz)
+        if (_bufManager.isAsyncWriteBack && leftPktSz)
+        {//last unit is always written back before reply, so the host gets the media state of the whole item
+            _bufManager.pendingData = unitData;
+            _bufManager.pendingSz   = thisWriteBackSz;
+        }
+        else
         {
-            const u8* src = data + burnSz;
-            u8* dest = (u8*)BufBase - leftSz;
-
-            if (totalTransferSz >= _bufManager.tplcmdTotalSz) {
-                DWN_ERR("Exception:packet end but data left 0x%x, totalTransferSz 0x%llx, cmd sz 0x%llx!\n",
-                        leftSz, totalTransferSz, _bufManager.tplcmdTotalSz);
-                return OPT_DOWN_FAIL;
-            }
-
-            if (leftSz > OPTIMUS_SPARSE_IMG_LEFT_DATA_MAX_SZ) {
-                DWN_ERR("Exception, left data sz 0x%x > back buf sz 0x%x!\n", leftSz, OPTIMUS_SPARSE_IMG_LEFT_DATA_MAX_SZ);
-                return OPT_DOWN_FAIL;
-            }
-            if (leftSz & 0x03) {
-                DWN_ERR("Exception, copy size not align to 4! May will copy fail!\n");
-                return OPT_DOWN_FAIL;
-            }
-
-            DWN_DBG("MV:left size 0x%08x, src %p, dest %p\n", leftSz, src, dest);
-            memcpy(dest, src, leftSz);
+            int ret = _buf_manager_write_back(unitData, thisWriteBackSz, reserveNotAlignSz, totalTransferSz >= _bufManager.tplcmdTotalSz, errInfo);
+            if (ret) return ret;
         }
 
-        //update _bufManager.leftDataSz and _bufManager.nextWriteBackSlot
-        _bufManager.leftDataSz = leftSz;
+        //update _bufManager.nextWriteBackSlot
         if (leftPktSz >= _bufManager.writeBackUnitSz)
         {
             _bufManager.nextWriteBackSlot += _bufManager.writeBackUnitSz/_bufManager.transferUnitSz;
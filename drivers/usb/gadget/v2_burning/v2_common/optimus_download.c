@@ -21,6 +21,8 @@ Description:
 #include "../v2_burning_i.h"
 #include <libfdt.h>
 #include <partition_table.h>
+#include <emmc_partitions.h>
+#include <amlogic/aml_mmc.h>
 #include <asm/arch/secure_apb.h>
 #include <asm/arch/bl31_apis.h>
 #include <asm/io.h>
@@ -269,6 +271,35 @@ u32 optimus_cb_simg_write_media(const unsigned destAddrInSec, const unsigned dat
     return dataSzInBy;
 }
 
+//trim media instead of writing zeros to it, for large zero-filled sparse chunks
+//return 0 if media can't be trimmed in range, then caller writes zeros instead
+u32 optimus_cb_simg_discard_media(const unsigned destAddrInSec, const unsigned dataSzInBy)
+{
+    char* partName = (char*)OptimusImgBurnInfo.partName;
+    struct partitions* partInfo = NULL;
+    const u64 offset = ((u64)destAddrInSec)<<9;
+    int dev = 0;
+
+    //trimmed nand reads 0xff, only emmc can trim to zeros
+    if (EMMC_BOOT_FLAG != device_boot_flag && SPI_EMMC_FLAG != device_boot_flag) return 0;
+    if (OPTIMUS_MEDIA_TYPE_STORE < OptimusImgBurnInfo.storageMediaType) return 0;
+    if (dataSzInBy & 0x1ff) return 0;
+
+    partInfo = find_mmc_partition_by_name(partName);
+    dev = find_dev_num_by_partition_name(partName);
+    if (!partInfo || dev < 0) return 0;
+    if (offset + dataSzInBy > partInfo->size) return 0;
+
+    //TRIM only, never the secure erase, which is slow and wears the flash
+    if (mmc_trim_zero(dev, (partInfo->offset + offset)>>9, dataSzInBy>>9)) {
+        DWN_DBG("no trim at 0x%llx in %s, write zeros instead\n", offset, partName);
+        return 0;
+    }
+    platform_busy_increase_un_reported_size(dataSzInBy);
+
+    return dataSzInBy;
+}
+
 //return value: the data size disposed
 static u32 optimus_download_sparse_image(struct ImgBurnInfo* pDownInfo, u32 dataSz, const u8* data)
 {
@@ -32,6 +32,7 @@ int optimus_buf_manager_get_buf_for_bulk_transfer(char** pBuf, const unsigned wa
 int optimus_buf_manager_report_transfer_complete(const u32 transferSz, char* errInfo);
 int is_largest_data_transferring(void);
 int optimus_buf_manager_get_command_data_for_upload_transfer(u8* cmdDataBuf, const unsigned bufLen);
+int optimus_buf_manager_write_back_pending(void);//write back one slice of the deferred write back unit, called when usb idle
 
 int optimus_download_init(void);
 int optimus_download_exit(void);
@@ -117,6 +118,9 @@ unsigned v2_key_burn(const char* keyName, const u8* keyVal, const unsigned keyVa
 
 #define OPTIMUS_VFAT_IMG_WRITE_BACK_SZ          (OPTIMUS_DOWNLOAD_SLOT_SZ*1)//update complete alogrithm if change it
 #define OPTIMUS_SIMG_WRITE_BACK_SZ              OPTIMUS_DOWNLOAD_TRANSFER_BUF_TOTALSZ
+//usb burning splits the transfer buf into a ring of write back units, so usb receives unit k+1 while unit k is written back
+#define OPTIMUS_SIMG_RING_WRITE_BACK_SZ         (OPTIMUS_DOWNLOAD_TRANSFER_BUF_TOTALSZ/2)
+#define OPTIMUS_ASYNC_WRITE_BACK_SLICE_SZ       (1U<<20)//deferred write back is done in 1M slices between usb polling
 #define OPTIMUS_MEMORY_WRITE_BACK_SZ            (0X2U<<30)//2GBytes
 #define OPTIMUS_BOOTLOADER_MAX_SZ               (2U<<20)//max size is 2M ??
 
@@ -152,6 +156,7 @@ unsigned v2_key_burn(const char* keyName, const u8* keyVal, const unsigned keyVa
 int optimus_simg_probe(const u8* source, const u32 length);
 int optimus_simg_parser_init(const u8* source);
 u32 optimus_cb_simg_write_media(const unsigned destAddrInSec, const unsigned dataSzInBy, const char* data);
+u32 optimus_cb_simg_discard_media(const unsigned destAddrInSec, const unsigned dataSzInBy);
 int optimus_simg_to_media(char* simgPktHead, const u32 pktLen, u32* unParsedDataLen, const u32 flashAddrInSec);
 int optimus_sparse_get_chunk_data(u8** head, u32* headSz, u32* dataSz, u64* dataOffset);
 int optimus_sparse_back_info_probe(void);
@@ -165,6 +170,7 @@ int optimus_hex_data_2_ascii_str(const unsigned char* hexData, const unsigned nB
 int optimus_progress_init(const unsigned itemSzHigh, const unsigned itemSzLow, const u32 startStep, const u32 endStep);
 int optimus_progress_exit(void);
 int optimus_update_progress(const unsigned thisBurnSz);
+int optimus_progress_media_write_stat(const unsigned thisWriteSz, const unsigned long costUs);//media write throughput
 
 #define DWN_ERR(fmt ...) printf("ERR(%s)L%d:", __FILE__, __LINE__);printf(fmt)
 #define DWN_MSG(fmt ...) printf("[MSG]"fmt)
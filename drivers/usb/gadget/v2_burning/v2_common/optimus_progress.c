@@ -40,6 +40,21 @@ struct ProgressInfo{
 };
 static struct ProgressInfo _progressInfo = {0};
 
+//throughput of an item: data received (from usb or package) vs data written to media
+struct ProgressStat{
+    unsigned long   startUs;
+    u64             recvSz;
+    u64             writeSz;
+    u64             writeUs;
+};
+static struct ProgressStat _progressStat = {0};
+
+static unsigned _progress_kbps(const u64 sz, u64 us)
+{
+    if (!us) us = 1;
+    return (unsigned)((sz * 1000000 / us)>>10);
+}
+
 int optimus_progress_init(const unsigned itemSzHigh, const unsigned itemSzLow, const u32 startStep, const u32 endStep)
 {
     _progressInfo.itemSzLow     = itemSzLow;
@@ -52,6 +67,9 @@ int optimus_progress_init(const unsigned itemSzHigh, const unsigned itemSzLow, c
 
     _progressInfo.unReportSzInByte  = 0;//clear it
 
+    memset(&_progressStat, 0, sizeof(_progressStat));
+    _progressStat.startUs = timer_get_us();
+
     //ATTENTION: as divisor / is lossy, _progressInfo.bytesToIncOneStep * _progressInfo.totalStepNum <= item size, so 100% is sometimes not exactly Burn Completed!!
     _progressInfo.bytesToIncOneStep = ((((u64)itemSzHigh)<<32) + itemSzLow) / _progressInfo.totalStepNum;
     _progressInfo.bytesToUpdateStep = (OPTIMUS_PROMPT_SIZE_MIN > _progressInfo.bytesToIncOneStep) ? OPTIMUS_PROMPT_SIZE_MIN : _progressInfo.bytesToIncOneStep;
@@ -67,9 +85,17 @@ int optimus_progress_exit(void)
     return 0;
 }
 
+int optimus_progress_media_write_stat(const unsigned thisWriteSz, const unsigned long costUs)
+{
+    _progressStat.writeSz += thisWriteSz;
+    _progressStat.writeUs += costUs;
+    return 0;
+}
+
 int optimus_update_progress(const unsigned thisBurnSz)
 {
     _progressInfo.unReportSzInByte += thisBurnSz;
+    _progressStat.recvSz           += thisBurnSz;
 
     if (_progressInfo.bytesToUpdateStep > _progressInfo.unReportSzInByte) {
         return 0;
@@ -84,9 +110,16 @@ int optimus_update_progress(const unsigned thisBurnSz)
     _progressInfo.currentStep       += _progressInfo.unReportSzInByte / _progressInfo.bytesToIncOneStep;
     _progressInfo.unReportSzInByte  %= _progressInfo.bytesToIncOneStep;
 
-    printf("Downloading %%%d\r", _progressInfo.currentStep);
+    printf("Downloading %%%d, %uKB/s\r", _progressInfo.currentStep,
+            _progress_kbps(_progressStat.recvSz, timer_get_us() - _progressStat.startUs));
     if (_progressInfo.currentStep == _progressInfo.endStep) {
+        const u64 totalUs = timer_get_us() - _progressStat.startUs;
+
         printf("\n");
+        //media write busy time near total time means the flash is the bottleneck, else the data source is
+        DWN_MSG("recv 0x%llx in %llums %uKB/s, media write 0x%llx busy %llums %uKB/s\n",
+                _progressStat.recvSz, totalUs/1000, _progress_kbps(_progressStat.recvSz, totalUs),
+                _progressStat.writeSz, _progressStat.writeUs/1000, _progress_kbps(_progressStat.writeSz, _progressStat.writeUs));
     }
 
     return 0;
@@ -38,6 +38,11 @@ extern int lcd_drawchars (ushort x, ushort y, uchar *str, int count);
 
 #if CONFIG_SD_BURNING_SUPPORT_UI
 
+//min ms between 2 redraws of the progress bar in smart mode, 0 to redraw on every percent
+#ifndef CONFIG_SD_BURNING_UI_UPDATE_MS
+#define CONFIG_SD_BURNING_UI_UPDATE_MS  0
+#endif// #ifndef CONFIG_SD_BURNING_UI_UPDATE_MS
+
 const char* const UpgradeLogoAddr = (const char*)(OPTIMUS_DOWNLOAD_DISPLAY_BUF + OPTIMUS_DOWNLOAD_SLOT_SZ);
 
 static int optimus_prepare_upgrading_bmps(HIMAGE hImg)
@@ -224,6 +229,8 @@ typedef struct _uiProgress{
 
     unsigned    bmpAddr_f;
     unsigned    reservToAlign64;
+
+    unsigned long lastUpdateTime;//get_timer() of the last redraw
 }UiProgress_t;
 
 
@@ -247,6 +254,7 @@ __hdle optimus_progress_ui_request(int totalPercents_f, int startPercent, unsign
 
     pUiProgress->totalPercents_f            = totalPercents_f;
     pUiProgress->curPercent                 = startPercent;
+    pUiProgress->lastUpdateTime             = get_timer(0);
     pUiProgress->endPercent_f               = startPercent + totalPercents_f;
 
 
@@ -408,6 +416,7 @@ int optimus_progress_ui_direct_update_progress(__hdle hUiProgress, const int per
 #endif// #ifdef CONFIG_OSD_SCALE_ENABLE
 
     pUiProgress->curPercent                 = percents;
+    pUiProgress->lastUpdateTime             = get_timer(0);
 
     optimus_progress_ui_set_steps(hUiProgress, percents);
 
@@ -425,8 +434,10 @@ int optimus_progress_ui_update_by_bytes(__hdle hUiPrgress, const unsigned nBytes
     int         ret             = 0;
     int percentsToReport        = 0;
 
-    //bytes not enghout to update one percent
-    if (bytesNotReport < nDownBytesOnePercent_f)
+    //bytes not enghout to update one percent, or redrawn too recently:
+    //keep the bytes and report them all with a later update, which then draws several percents at once
+    if (bytesNotReport < nDownBytesOnePercent_f
+            || get_timer(pUiProgress->lastUpdateTime) < CONFIG_SD_BURNING_UI_UPDATE_MS)
     {
         pUiProgress->smartModeLeftBytes = bytesNotReport;
         return 0;
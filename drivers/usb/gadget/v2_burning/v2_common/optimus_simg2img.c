@@ -29,6 +29,11 @@ Description:
 #define  CHUNK_HEAD_SIZE        sizeof(chunk_header_t)
 #define  FILE_HEAD_SIZE         sizeof(sparse_header_t)
 
+//small RAW chunks contiguous in flash are moved together and written at once, as each write has fixed cost
+#define  RAW_COALESCE_MAX_SZ    (256U<<10)
+//zero FILL chunks at least this size are trimmed instead of written when trimmed media reads 0
+#define  FILL_DISCARD_MIN_SZ    (1U<<20)
+
 //states for a sparse packet, initialized when sparse packet probed
 static struct
 {
@@ -100,6 +105,24 @@ int optimus_simg_parser_init(const u8* source)
 	return OPT_DOWN_OK;
 }
 
+//write the coalesced RAW chunks
+static int _simg_flush_raw_run(const char* runData, unsigned* runLen, const unsigned runFlashAddr)
+{
+    unsigned thisWriteLen = 0;
+
+    if (!*runLen) return 0;
+
+    spdbg("raw run 0x%x at 0x%xSec\n", *runLen, runFlashAddr);
+    thisWriteLen = optimus_cb_simg_write_media(runFlashAddr, *runLen, runData);
+    if (thisWriteLen != *runLen) {
+        sperr("Fail to write raw run to flash, want to write %dB, but %dB\n", *runLen, thisWriteLen);
+        return __LINE__;
+    }
+    *runLen = 0;
+
+    return 0;
+}
+
 //return value: flash address offset in sector in this time dispose
 //call this method to parse sparse format data and write it to media
 //@flashAddrInSec: flash write address of first chunk
@@ -114,6 +137,9 @@ int optimus_simg_to_media(char* simgPktHead, const u32 pktLen, u32* unParsedData
     u32 flashAddrStart = flashAddrInSec;
     chunk_header_t* pChunk = (chunk_header_t*)(simgPktHead + _spPacketStates.pktHeadLen);
     chunk_header_t* backChunkHead = (chunk_header_t*)(_spPacketStates.chunkInfoBackAddr + FILE_HEAD_SIZE) + _spPacketStates.backChunkNum;
+    char*    rawRunData     = NULL;//RAW chunks moved together but not written yet
+    unsigned rawRunLen      = 0;
+    unsigned rawRunFlashAddr= 0;
 
     if (notWrBackSz4LongChunk && !_spPacketStates.pktHeadLen/*0 if head*/)
     {
@@ -158,11 +184,13 @@ int optimus_simg_to_media(char* simgPktHead, const u32 pktLen, u32* unParsedData
         //chunk data for ext4, but maybe empty in sparse, that is why called sparse format
         const unsigned chunkDataLen = pChunk->chunk_sz * _spPacketStates.sparseBlkSz;
         unsigned thisWriteLen = 0;
+        chunk_header_t thisChunkHead;//pChunk may be overwritten when its RAW data moved to coalesce
 
         if (CHUNK_HEAD_SIZE > unParsedBufLen) {//total size not enough for CHUNK_HEAD_SIZE yet!!
             spmsg("unParsedBufLen 0x%x < head sz 0x%zx\n", unParsedBufLen, CHUNK_HEAD_SIZE);
             break;
         }
+        memcpy(&thisChunkHead, pChunk, CHUNK_HEAD_SIZE);
 
         switch (pChunk->chunk_type)
         {
@@ -187,8 +215,26 @@ int optimus_simg_to_media(char* simgPktHead, const u32 pktLen, u32* unParsedData
                             unParseChunkDataLen, chunkDataLen, wantWrLen, _spPacketStates.notWrBackSz4LongChunk);
                 }
 
-                if (wantWrLen)
+                if (wantWrLen == chunkDataLen && chunkDataLen <= RAW_COALESCE_MAX_SZ)
                 {
+                    char* chunkData = (char*)pChunk + CHUNK_HEAD_SIZE;
+
+                    if (rawRunLen && rawRunFlashAddr + (rawRunLen>>9) == flashAddrStart) {
+                        //move over the chunk header(s) between, only parsed data is overwritten
+                        memmove(rawRunData + rawRunLen, chunkData, chunkDataLen);
+                        rawRunLen += chunkDataLen;
+                    }
+                    else {
+                        if (_simg_flush_raw_run(rawRunData, &rawRunLen, rawRunFlashAddr)) return -__LINE__;
+                        rawRunData      = chunkData;
+                        rawRunLen       = chunkDataLen;
+                        rawRunFlashAddr = flashAddrStart;
+                    }
+                    thisWriteLen = chunkDataLen;
+                }
+                else if (wantWrLen)
+                {
+                    if (_simg_flush_raw_run(rawRunData, &rawRunLen, rawRunFlashAddr)) return -__LINE__;
                     thisWriteLen = optimus_cb_simg_write_media(flashAddrStart, wantWrLen, (char*)pChunk + CHUNK_HEAD_SIZE);
                     if (thisWriteLen != wantWrLen) {
                         sperr("Fail to write to flash, want to write %dB, but %dB\n", wantWrLen, thisWriteLen);
@@ -243,6 +289,14 @@ int optimus_simg_to_media(char* simgPktHead, const u32 pktLen, u32* unParsedData
                     //for, emmc, if fillVal is 0, then _NeedFillAsNotErasedYet = false if "disk_inital > 0"
                     if (!_NeedFillAsNotErasedYet)_NeedFillAsNotErasedYet = (is_optimus_storage_inited()>>16) == 0;// == 0 means 'disk_inital 0'
 
+                    //zero-filled range is trimmed instead of written if media supports it
+                    if (_NeedFillAsNotErasedYet && !fillVal && chunkDataLen >= FILL_DISCARD_MIN_SZ
+                            && chunkDataLen == optimus_cb_simg_discard_media(flashAddrStart, chunkDataLen))
+                    {
+                            spdbg("FILL chunk 0x%x discarded\n", chunkDataLen);
+                            _NeedFillAsNotErasedYet = 0;
+                    }
+
                     if (_NeedFillAsNotErasedYet)
                     {
                             if (!_filledBufValidLen) {
@@ -289,13 +343,15 @@ int optimus_simg_to_media(char* simgPktHead, const u32 pktLen, u32* unParsedData
         /////update for next chunk
         unParsedBufLen                  -= CHUNK_HEAD_SIZE + thisWriteLen;
         flashAddrStart                  += chunkDataLen>>9;
-        memcpy(backChunkHead, pChunk, CHUNK_HEAD_SIZE);//back up verify chunk info
+        memcpy(backChunkHead, &thisChunkHead, CHUNK_HEAD_SIZE);//back up verify chunk info
         spdbg("index %d ,tp 0x%x\n", _spPacketStates.backChunkNum, backChunkHead->chunk_type);
         ++_spPacketStates.backChunkNum;
         ++backChunkHead;
 
-        pChunk                           =  (chunk_header_t*)((u64)pChunk + pChunk->total_sz);
+        pChunk                           =  (chunk_header_t*)((u64)pChunk + thisChunkHead.total_sz);
     }
+    //all parsed data must be on media when return, as the buffer will be reused
+    if (_simg_flush_raw_run(rawRunData, &rawRunLen, rawRunFlashAddr)) return -__LINE__;
 
     spmsg("leftChunkNum %d, bak num %d\n", _spPacketStates.leftChunkNum, _spPacketStates.backChunkNum);
 
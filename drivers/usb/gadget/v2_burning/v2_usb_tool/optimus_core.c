@@ -53,6 +53,8 @@ int v2_usbburning(unsigned timeout)
                 //watchdog_clear();		//Elvis Fool
                 if (usb_pcd_irq())
                         break;
+                //write back the deferred unit slice by slice, so usb keeps receiving the next unit
+                optimus_buf_manager_write_back_pending();
         }
         return 0;
 }
@@ -40,3 +40,23 @@ int write_sparse_image(
 		struct sparse_storage *info,
 		const char *part_name,
 		void *data, unsigned sz);
+
+#ifdef CONFIG_FASTBOOT_FLASH_STREAM
+/* state of a sparse image written as it is received */
+struct sparse_stream {
+	sparse_header_t	header;
+	int		header_done;
+	unsigned int	chunk;		/* chunks done */
+	uint64_t	raw_left;	/* data of the current RAW chunk not written */
+	lbaint_t	blk;		/* next block to write */
+	uint32_t	total_blocks;
+	uint64_t	bytes_written;
+};
+
+void write_sparse_stream_init(struct sparse_storage *info,
+		struct sparse_stream *st);
+int write_sparse_image_stream(struct sparse_storage *info,
+		struct sparse_stream *st, void *data, unsigned sz,
+		unsigned *used);
+int write_sparse_stream_end(struct sparse_stream *st, const char *part_name);
+#endif
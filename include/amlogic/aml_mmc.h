@@ -77,6 +77,15 @@ int find_dev_num_by_partition_name (char *name);
 int emmc_update_mbr(unsigned char *buffer);
 #endif
 
+/*
+ * blocks of one write from a source not cache line aligned, the sd_emmc
+ * host copies those to a bounce buffer instead of writing them in place.
+ */
+#define AML_MMC_BOUNCE_BLKS	256
+
+/* trim to zeros instead of writing them, -1 if the device can't */
+int mmc_trim_zero(int dev_num, lbaint_t start, lbaint_t blkcnt);
+
 /*mmc ext_csd register operation*/
 int mmc_get_ext_csd(struct mmc *mmc, u8 *ext_csd);
 int mmc_set_ext_csd(struct mmc *mmc, u8 index, u8 value);
@@ -0,0 +1,76 @@
+/*
+ * include/amlogic/display_async.h
+ *
+ * Copyright (C) 2018 Amlogic, Inc. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+*/
+
+#ifndef __DISPLAY_ASYNC_H__
+#define __DISPLAY_ASYNC_H__
+
+/*
+ * Deferred display bring-up.
+ *
+ * Display work that is mostly waiting, such as a panel power sequence,
+ * is written as a task whose step() does one step and returns how long
+ * to wait before the next one. With CONFIG_AML_DISPLAY_ASYNC the waits
+ * are not slept: display_async_poll() runs the steps that are due and
+ * is called between commands and while the boot images are loaded, so
+ * the delays overlap with storage reads and verification.
+ *
+ * display_async_sync() finishes all queued work. It must be called
+ * before the display is reconfigured and before the kernel is started.
+ *
+ * Without CONFIG_AML_DISPLAY_ASYNC a task runs to the end when started,
+ * sleeping in between its steps.
+ */
+#define DISPLAY_ASYNC_DONE	(-1)
+
+struct display_async_task {
+	const char *name;
+	/* ms to wait before the next step, DISPLAY_ASYNC_DONE at the end */
+	int (*step)(struct display_async_task *task);
+	int state;		/* free for step() */
+	ulong wake;		/* get_timer() value the next step is due */
+	ulong start;
+	struct display_async_task *next;
+};
+
+#ifdef CONFIG_AML_DISPLAY_ASYNC
+/* queue @task and run its first steps, a queued task is left alone */
+void display_async_start(struct display_async_task *task);
+
+/* run the steps that are due, cheap when nothing is queued */
+void display_async_poll(void);
+
+/* run all queued tasks to the end */
+void display_async_sync(void);
+
+/* non zero while a task is queued */
+int display_async_pending(void);
+#else
+static inline void display_async_start(struct display_async_task *task)
+{
+	int delay;
+
+	while ((delay = task->step(task)) != DISPLAY_ASYNC_DONE)
+		if (delay > 0)
+			mdelay(delay);
+}
+
+static inline void display_async_poll(void) {}
+static inline void display_async_sync(void) {}
+static inline int display_async_pending(void) { return 0; }
+#endif
+
+#endif /* __DISPLAY_ASYNC_H__ */
@@ -43,6 +43,18 @@ int key_unify_query_canOverWrite(const char* keyname, int* canOverWrite);
 //Does the key configured in dts
 int key_unify_query_key_has_configure(const char* keyname);
 
+//one key of key_unify_read_batch
+struct key_unify_batch_t {
+    const char* name;
+    void*       buf;    //NULL to only query the size
+    unsigned    bufLen;
+    ssize_t     size;   //out: key size
+    int         err;    //out: 0 ok, -ENOENT not cfg/programmed, -EACCES secure, -ENOSPC buf too small, -EIO
+};
+
+//query and read @num keys at once, return the number of keys failed
+int key_unify_read_batch(struct key_unify_batch_t* keys, const int num);
+
 //Another APIs with APP concers, like special flower hdcp2
 //These APIs are based on key_unify_*
 //
@@ -24,6 +24,9 @@
  *   dev: should be "struct udevice *"
  * @num_chipselect:
  * @cs_gpios:
+ * @cs_hw_enable(): callback to hand the cs pin to the controller (enable)
+ *   or back to its gpio, needed by CONFIG_SPIFC_AHB_READ as the memory
+ *   mapped reads are framed by the controller itself.
  */
 
 /*
@@ -47,6 +50,7 @@ struct spifc_platdata {
 	int (*clk_enable)(void *clk, bool enable);
 	void *(*pinctrl_get)(void *dev, char *name);
 	int (*pinctrl_enable)(void *pinctrl, bool enable);
+	int (*cs_hw_enable)(void *pinctrl, bool enable);
 	int num_chipselect;
 	int *cs_gpios;
 };
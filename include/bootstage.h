@@ -194,6 +194,15 @@ enum bootstage_id {
 	BOOTSTAGE_ID_MAIN_CPU_READY,
 
 	BOOTSTAGE_ID_ACCUM_LCD,
+	BOOTSTAGE_ID_ACCUM_STORE_READ,
+	BOOTSTAGE_ID_ACCUM_STORE_WRITE,
+	BOOTSTAGE_ID_ACCUM_DECOMP,
+	BOOTSTAGE_ID_ACCUM_HASH,
+	BOOTSTAGE_ID_ACCUM_FDT_FIXUP,
+	BOOTSTAGE_ID_ACCUM_HUSH_PARSE,
+	BOOTSTAGE_ID_ACCUM_AVB_READ,
+	BOOTSTAGE_ID_ACCUM_AVB_HASH,
+	BOOTSTAGE_ID_ACCUM_AVB_VBMETA,
 
 	/* a few spare for the user, from here */
 	BOOTSTAGE_ID_USER,
@@ -294,6 +303,18 @@ uint32_t bootstage_start(enum bootstage_id id, const char *name);
  */
 uint32_t bootstage_accum(enum bootstage_id id);
 
+/**
+ * Mark the end of a bootstage activity which processed some data
+ *
+ * Same as bootstage_accum(), and also adds @bytes to the amount of data
+ * of this id, so that the report can show the data rate of the activity.
+ *
+ * @param id	Bootstage id to record this timestamp against
+ * @param bytes	Number of bytes read, written, hashed, etc. in this iteration
+ * @return time spent in this iteration of the activity
+ */
+uint32_t bootstage_accum_data(enum bootstage_id id, ulong bytes);
+
 /* Print a report about boot time */
 void bootstage_report(void);
 
@@ -376,6 +397,11 @@ static inline uint32_t bootstage_accum(enum bootstage_id id)
 	return 0;
 }
 
+static inline uint32_t bootstage_accum_data(enum bootstage_id id, ulong bytes)
+{
+	return 0;
+}
+
 static inline int bootstage_stash(void *base, int size)
 {
 	return 0;	/* Pretend to succeed */
@@ -24,4 +24,10 @@ char *get_local_var(const char *s);
 #if defined(CONFIG_HUSH_INIT_VAR)
 extern int hush_init_var (void);
 #endif
+
+#ifdef CONFIG_HUSH_PROFILE
+/* time per command run by hush, nested commands included */
+void hush_prof_report(void);
+void hush_prof_reset(void);
+#endif
 #endif
@@ -200,6 +200,7 @@
 #define CONFIG_BZIP2
 #define CONFIG_LZO
 #define CONFIG_LZMA
+#define CONFIG_LZ4
 
 #define CONFIG_TPM_TIS_SANDBOX
 
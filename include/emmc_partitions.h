@@ -126,6 +126,14 @@ Description:
 #define DDR_PARAMETER_OFFSET	(SZ_1M * 8)
 #define DDR_PARAMETER_SIZE	(4 * 512)
 
+/*
+ * HS400 tuning result, reused while the cid and clock match
+ * and the calibration pattern reads back fine with it.
+ */
+#define MMC_TUNING_NAME		"tuning"
+#define TUNING_OFFSET		(SZ_1M * 9)
+#define TUNING_SIZE		(512)
+
 /*
  * 2 copies dtb were stored in dtb area.
  * each is 256K.
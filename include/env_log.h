@@ -0,0 +1,44 @@
+/*
+ * Append only log of environment changes, kept next to the saved
+ * environment so that saveenv only writes what changed.
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef _ENV_LOG_H_
+#define _ENV_LOG_H_
+
+#include <environment.h>
+
+#ifndef CONFIG_ENV_LOG_SIZE
+#define CONFIG_ENV_LOG_SIZE	(64 << 10)
+#endif
+
+/*
+ * Storage of the log area, offsets are relative to its start.
+ * blksz is the write unit, every record starts on a new unit so a
+ * torn write never damages an older record.
+ */
+struct env_log_ops {
+	ulong	blksz;
+	ulong	size;
+	int	(*read)(ulong offset, ulong size, void *buf);
+	int	(*write)(ulong offset, ulong size, const void *buf);
+};
+
+/*
+ * replay the log on top of the imported @base, 0 if nothing to replay.
+ * The log only applies to the base it was started behind: if the base
+ * was rewritten by anything else (fw_setenv, a flashed image), the log
+ * and the changes in it are dropped with a warning, and the next
+ * saveenv writes the whole environment.
+ */
+int env_log_replay(const struct env_log_ops *ops, const env_t *base);
+
+/* append the changes since the last save, nonzero if a full save is due */
+int env_log_save(const struct env_log_ops *ops);
+
+/* start an empty log behind the freshly written @base */
+int env_log_reset(const struct env_log_ops *ops, const env_t *base);
+
+#endif /* _ENV_LOG_H_ */
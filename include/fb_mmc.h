@@ -6,3 +6,15 @@
 
 void fb_mmc_flash_write(const char *cmd, void *download_buffer,
 			unsigned int download_bytes);
+
+#ifdef CONFIG_FASTBOOT_FLASH_STREAM
+/*
+ * Flash an image to partition @cmd while it is downloaded: start, then
+ * write the data in pieces as it comes, then end sets the fastboot response.
+ * *@used is the head of @buffer disposed, the rest must be passed again.
+ */
+int fb_mmc_stream_start(const char *cmd, uint64_t *part_bytes);
+int fb_mmc_stream_write(void *buffer, unsigned int bytes, int is_last,
+			unsigned int *used);
+void fb_mmc_stream_end(void);
+#endif
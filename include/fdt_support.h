@@ -100,6 +100,40 @@ void ft_pci_setup(void *blob, bd_t *bd);
  */
 int ft_system_setup(void *blob, bd_t *bd);
 
+/*
+ * Batched property edits: between fdt_batch_begin() and fdt_batch_commit()
+ * fdt_batch_setprop() only records the edit, the commit applies them all
+ * in one pass over the blob. Without an open batch on @fdt the edit is
+ * applied at once. Missing nodes of @path are created.
+ */
+int fdt_batch_begin(void *fdt);
+int fdt_batch_setprop(void *fdt, const char *path, const char *name,
+		      const void *val, int len);
+int fdt_batch_commit(void *fdt);
+void fdt_batch_abort(void);
+
+static inline int fdt_batch_setprop_string(void *fdt, const char *path,
+					   const char *name, const char *str)
+{
+	return fdt_batch_setprop(fdt, path, name, str, strlen(str) + 1);
+}
+
+static inline int fdt_batch_setprop_u32(void *fdt, const char *path,
+					const char *name, uint32_t val)
+{
+	fdt32_t tmp = cpu_to_fdt32(val);
+
+	return fdt_batch_setprop(fdt, path, name, &tmp, sizeof(tmp));
+}
+
+static inline int fdt_batch_setprop_u64(void *fdt, const char *path,
+					const char *name, uint64_t val)
+{
+	fdt64_t tmp = cpu_to_fdt64(val);
+
+	return fdt_batch_setprop(fdt, path, name, &tmp, sizeof(tmp));
+}
+
 void set_working_fdt_addr(void *addr);
 int fdt_shrink_to_minimum(void *blob);
 int fdt_increase_size(void *fdt, int add_len);
@@ -48,5 +48,19 @@
 #undef AVB_INSIDE_LIBAVB_H
 
 int avb_verify(AvbSlotVerifyData** out_data);
+/*
+ * |partition| has been read to |addr|, |loaded| bytes from its start and
+ * room for |capacity|: the next avb_verify() hashes it in place. NULL
+ * |partition| drops it.
+ */
+void avb_set_preloaded_partition(const char* partition,
+                                 void* addr,
+                                 size_t loaded,
+                                 size_t capacity);
 int is_device_unlocked(void);
+/* read/hash/vbmeta time per partition of the last avb_verify() */
+void avb_stats_reset(void);
+void avb_stats_print(void);
+/* throughput of the sha backends over |len| bytes at |buf| */
+void avb_sha_bench(const uint8_t* buf, size_t len);
 #endif /* LIBAVB_H_ */
@@ -116,6 +116,24 @@ size_t avb_strlen(const char* str) AVB_ATTR_WARN_UNUSED_RESULT;
  * remainder. */
 uint32_t avb_div_by_10(uint64_t* dividend);
 
+/* Phases of slot verification accounted by avb_stats_start() and
+ * avb_stats_end(). */
+typedef enum {
+  AVB_STATS_READ,
+  AVB_STATS_HASH,
+  AVB_STATS_VBMETA,
+  AVB_STATS_NUM_PHASES
+} AvbStatsPhase;
+
+/* Marks the start of |phase|. Phases do not nest with themselves. */
+void avb_stats_start(AvbStatsPhase phase);
+
+/* Marks the end of |phase|, which processed |num_bytes| bytes of
+ * partition |part_name|. */
+void avb_stats_end(AvbStatsPhase phase,
+                   const char* part_name,
+                   uint64_t num_bytes);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,27 @@
+/*
+ * Copyright (C) 2018 Amlogic, Inc. All rights reserved.
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef __LZ4_H
+#define __LZ4_H
+
+/**
+ * ulz4fn() - decompress an LZ4 stream
+ *
+ * Both the LZ4 frame format (magic 0x184D2204, as written by 'lz4') and
+ * the legacy format (magic 0x184C2102, as written by 'lz4 -l' for the
+ * kernel Image.lz4) are supported. Concatenated and skippable frames are
+ * handled; block and content checksums are not verified.
+ *
+ * @src:	Compressed data
+ * @srcn:	Size of compressed data
+ * @dst:	Output buffer
+ * @dstn:	Size of output buffer on input, decompressed size on output
+ * @return 0 if OK, -EPROTONOSUPPORT for an unknown format or frame
+ * option, -EINVAL for corrupted data, -ENOBUFS if @dst is too small
+ */
+int ulz4fn(const void *src, size_t srcn, void *dst, size_t *dstn);
+
+#endif /* __LZ4_H */
@@ -111,6 +111,7 @@
 #define OCR_ACCESS_MODE		0x60000000
 
 #define SECURE_ERASE		0x80000000
+#define MMC_TRIM_ARG		0x00000001
 
 #define MMC_STATUS_MASK		(~0x0206BF7F)
 #define MMC_STATUS_SWITCH_ERROR	(1 << 7)
@@ -172,6 +173,8 @@
 #define EXT_CSD_ERASE_GROUP_DEF		175	/* R/W */
 #define EXT_CSD_BOOT_BUS_WIDTH		177
 #define EXT_CSD_PART_CONF		179	/* R/W */
+#define EXT_CSD_ERASED_MEM_CONT		181	/* RO */
+#define EXT_CSD_STROBE_SUPPORT		184	/* RO */
 #define EXT_CSD_BUS_WIDTH		183	/* R/W */
 #define EXT_CSD_HS_TIMING		185	/* R/W */
 #define EXT_CSD_REV			192	/* RO */
@@ -181,6 +184,7 @@
 #define EXT_CSD_HC_WP_GRP_SIZE		221	/* RO */
 #define EXT_CSD_HC_ERASE_GRP_SIZE	224	/* RO */
 #define EXT_CSD_BOOT_MULT		226	/* RO */
+#define EXT_CSD_SEC_FEATURE_SUPPORT	231	/* RO */
 #define EXT_CSD_BKOPS_SUPPORT		502	/* RO */
 #define EXT_CSD_SUPPORTED_MODES	493 /* RO */
 #define EXT_CSD_FW_VERSION	254 /* RO, 261:254 */
@@ -194,6 +198,8 @@
 /*
  * EXT_CSD field definitions
  */
+#define EXT_CSD_SEC_GB_CL_EN		(1 << 4)	/* TRIM supported */
+
 #define EXT_CSD_CMD_SET_NORMAL		(1 << 0)
 #define EXT_CSD_CMD_SET_SECURE		(1 << 1)
 #define EXT_CSD_CMD_SET_CPSECURE	(1 << 2)
@@ -218,6 +224,7 @@
 #define EXT_CSD_DDR_BUS_WIDTH_4	5	/* Card is in 4 bit DDR mode */
 #define EXT_CSD_DDR_BUS_WIDTH_8	6	/* Card is in 8 bit DDR mode */
 #define EXT_CSD_DDR_FLAG	BIT(2)	/* Flag for DDR mode */
+#define EXT_CSD_BUS_WIDTH_STROBE	(1 << 7)	/* Enhanced strobe mode */
 
 #define EXT_CSD_TIMING_LEGACY	0	/* no high speed */
 #define EXT_CSD_TIMING_HS	1	/* HS */
@@ -312,6 +319,14 @@
 //#define MMC_HS200_MODE
 //#define MMC_HS400_MODE
 
+/* boards select the eMMC bus mode with CONFIG_EMMC_HS200/CONFIG_EMMC_HS400 */
+#if defined(CONFIG_EMMC_HS400) && !defined(MMC_HS400_MODE)
+#define MMC_HS400_MODE
+#endif
+#if (defined(CONFIG_EMMC_HS200) || defined(MMC_HS400_MODE)) && !defined(MMC_HS200_MODE)
+#define MMC_HS200_MODE
+#endif
+
 struct mmc_cid {
 	unsigned long psn;
 	unsigned short oid;
@@ -411,6 +426,7 @@ struct mmc {
 	u8 part_support;
 	u8 part_attr;
 	u8 wr_rel_set;
+	u8 trim_zero;		/* TRIM supported and erased memory reads 0 */
 	uint read_bl_len;
 	uint write_bl_len;
 	uint erase_grp_size;
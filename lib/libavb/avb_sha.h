@@ -39,6 +39,9 @@ extern "C" {
 
 #include <libavb/avb_crypto.h>
 #include <libavb/avb_sysdeps.h>
+#ifdef CONFIG_AML_HW_SHA2
+#include <u-boot/sha256.h>
+#endif
 
 /* Block size in bytes of a SHA-256 digest. */
 #define AVB_SHA256_BLOCK_SIZE 64
@@ -54,6 +57,9 @@ typedef struct {
   uint32_t len;
   uint8_t block[2 * AVB_SHA256_BLOCK_SIZE];
   uint8_t buf[AVB_SHA256_DIGEST_SIZE]; /* Used for storing the final digest. */
+#ifdef CONFIG_AML_HW_SHA2
+  sha256_context hw; /* State of the SoC SHA-2 engine. */
+#endif
 } AvbSHA256Ctx;
 
 /* Data structure used for SHA-512. */
@@ -65,6 +71,15 @@ typedef struct {
   uint8_t buf[AVB_SHA512_DIGEST_SIZE]; /* Used for storing the final digest. */
 } AvbSHA512Ctx;
 
+/* SHA-256 in portable C, what avb_sha256_*() use without a platform
+ * engine. Kept available to compare against it.
+ */
+void avb_sha256_sw_init(AvbSHA256Ctx* ctx);
+void avb_sha256_sw_update(AvbSHA256Ctx* ctx,
+                          const uint8_t* data,
+                          uint32_t len);
+uint8_t* avb_sha256_sw_final(AvbSHA256Ctx* ctx) AVB_ATTR_WARN_UNUSED_RESULT;
+
 /* Initializes the SHA-256 context. */
 void avb_sha256_init(AvbSHA256Ctx* ctx);
 
@@ -100,7 +100,7 @@ static const uint32_t sha256_k[64] = {
     0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
 
 /* SHA-256 implementation */
-void avb_sha256_init(AvbSHA256Ctx* ctx) {
+void avb_sha256_sw_init(AvbSHA256Ctx* ctx) {
 #ifndef UNROLL_LOOPS
   int i;
   for (i = 0; i < 8; i++) {
@@ -320,7 +320,9 @@ static void SHA256_transform(AvbSHA256Ctx* ctx,
   }
 }
 
-void avb_sha256_update(AvbSHA256Ctx* ctx, const uint8_t* data, uint32_t len) {
+void avb_sha256_sw_update(AvbSHA256Ctx* ctx,
+                          const uint8_t* data,
+                          uint32_t len) {
   unsigned int block_nb;
   unsigned int new_len, rem_len, tmp_len;
   const uint8_t* shifted_data;
@@ -351,7 +353,7 @@ void avb_sha256_update(AvbSHA256Ctx* ctx, const uint8_t* data, uint32_t len) {
   ctx->tot_len += (block_nb + 1) << 6;
 }
 
-uint8_t* avb_sha256_final(AvbSHA256Ctx* ctx) {
+uint8_t* avb_sha256_sw_final(AvbSHA256Ctx* ctx) {
   unsigned int block_nb;
   unsigned int pm_len;
   unsigned int len_b;
@@ -388,3 +390,35 @@ uint8_t* avb_sha256_final(AvbSHA256Ctx* ctx) {
 
   return ctx->buf;
 }
+
+#ifdef CONFIG_AML_HW_SHA2
+/* The SoC SHA-2 engine DMAs the data itself, which is much faster for
+ * the large images hashed during slot verification. It is driven
+ * through the U-Boot sha256 API, the same path FIT image hashes and
+ * signatures take.
+ */
+void avb_sha256_init(AvbSHA256Ctx* ctx) {
+  sha256_starts(&ctx->hw);
+}
+
+void avb_sha256_update(AvbSHA256Ctx* ctx, const uint8_t* data, uint32_t len) {
+  sha256_update(&ctx->hw, data, len);
+}
+
+uint8_t* avb_sha256_final(AvbSHA256Ctx* ctx) {
+  sha256_finish(&ctx->hw, ctx->buf);
+  return ctx->buf;
+}
+#else
+void avb_sha256_init(AvbSHA256Ctx* ctx) {
+  avb_sha256_sw_init(ctx);
+}
+
+void avb_sha256_update(AvbSHA256Ctx* ctx, const uint8_t* data, uint32_t len) {
+  avb_sha256_sw_update(ctx, data, len);
+}
+
+uint8_t* avb_sha256_final(AvbSHA256Ctx* ctx) {
+  return avb_sha256_sw_final(ctx);
+}
+#endif /* CONFIG_AML_HW_SHA2 */
@@ -293,6 +293,7 @@ static AvbSlotVerifyResult load_and_verify_hash_partition(
     goto out;
   }
 
+  avb_stats_start(AVB_STATS_HASH);
   if (avb_strcmp((const char*)hash_desc.hash_algorithm, "sha256") == 0) {
     AvbSHA256Ctx sha256_ctx;
     avb_sha256_init(&sha256_ctx);
@@ -308,10 +309,12 @@ static AvbSlotVerifyResult load_and_verify_hash_partition(
     digest = avb_sha512_final(&sha512_ctx);
     digest_len = AVB_SHA512_DIGEST_SIZE;
   } else {
+    avb_stats_end(AVB_STATS_HASH, part_name, 0);
     avb_errorv(part_name, ": Unsupported hash algorithm.\n", NULL);
     ret = AVB_SLOT_VERIFY_RESULT_ERROR_INVALID_METADATA;
     goto out;
   }
+  avb_stats_end(AVB_STATS_HASH, part_name, hash_desc.image_size);
 
   if (hash_desc.digest_len == 0) {
     // Expect a match to a persistent digest.
@@ -620,8 +623,10 @@ static AvbSlotVerifyResult load_and_verify_vbmeta(
   /* Check if the image is properly signed and get the public key used
    * to sign the image.
    */
+  avb_stats_start(AVB_STATS_VBMETA);
   vbmeta_ret =
       avb_vbmeta_image_verify(vbmeta_buf, vbmeta_num_read, &pk_data, &pk_len);
+  avb_stats_end(AVB_STATS_VBMETA, full_partition_name, vbmeta_num_read);
   switch (vbmeta_ret) {
     case AVB_VBMETA_VERIFY_RESULT_OK:
       avb_assert(pk_data != NULL && pk_len > 0);
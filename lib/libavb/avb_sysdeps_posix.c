@@ -30,6 +30,9 @@
 
 #include <libavb/avb_sysdeps.h>
 
+#include "avb_cmdline.h"
+#include "avb_sha.h"
+
 int avb_memcmp(const void* src1, const void* src2, size_t n) {
   return memcmp(src1, src2, n);
 }
@@ -83,3 +86,137 @@ uint32_t avb_div_by_10(uint64_t* dividend) {
   *dividend /= 10;
   return rem;
 }
+
+/* Per partition statistics of the last slot verification. */
+#define AVB_STATS_MAX_PARTITIONS 8
+
+typedef struct {
+  char name[AVB_PART_NAME_MAX_SIZE];
+  uint64_t bytes[AVB_STATS_NUM_PHASES];
+  uint64_t time_us[AVB_STATS_NUM_PHASES];
+} AvbStatsPartition;
+
+static AvbStatsPartition avb_stats[AVB_STATS_MAX_PARTITIONS];
+static ulong avb_stats_start_us[AVB_STATS_NUM_PHASES];
+
+static const struct {
+  enum bootstage_id id;
+  const char* name;
+} avb_stats_bootstage[AVB_STATS_NUM_PHASES] = {
+    {BOOTSTAGE_ID_ACCUM_AVB_READ, "avb_read"},
+    {BOOTSTAGE_ID_ACCUM_AVB_HASH, "avb_hash"},
+    {BOOTSTAGE_ID_ACCUM_AVB_VBMETA, "avb_vbmeta"},
+};
+
+void avb_stats_start(AvbStatsPhase phase) {
+  bootstage_start(avb_stats_bootstage[phase].id,
+                  avb_stats_bootstage[phase].name);
+  avb_stats_start_us[phase] = timer_get_us();
+}
+
+void avb_stats_end(AvbStatsPhase phase,
+                   const char* part_name,
+                   uint64_t num_bytes) {
+  ulong us = timer_get_us() - avb_stats_start_us[phase];
+  AvbStatsPartition* p;
+
+  bootstage_accum_data(avb_stats_bootstage[phase].id, num_bytes);
+  for (p = avb_stats; p < avb_stats + AVB_STATS_MAX_PARTITIONS; p++) {
+    if (p->name[0] == '\0') {
+      strncpy(p->name, part_name, sizeof(p->name) - 1);
+      break;
+    }
+    if (strcmp(p->name, part_name) == 0) {
+      break;
+    }
+  }
+  if (p == avb_stats + AVB_STATS_MAX_PARTITIONS) {
+    return;
+  }
+  p->bytes[phase] += num_bytes;
+  p->time_us[phase] += us;
+}
+
+void avb_stats_reset(void) {
+  memset(avb_stats, 0, sizeof(avb_stats));
+}
+
+/* bytes per us is MB/s */
+static void avb_stats_print_phase(uint64_t bytes, uint64_t us) {
+  uint64_t div = us ? us : 1;
+
+  printf(" %8llu %9llu %4llu.%02llu",
+         bytes >> 10,
+         us,
+         bytes / div,
+         bytes % div * 100 / div);
+}
+
+void avb_stats_print(void) {
+  AvbStatsPartition* p;
+
+  printf("%-16s %8s %9s %7s %8s %9s %7s %9s\n",
+         "partition",
+         "read KiB",
+         "read us",
+         "MB/s",
+         "hash KiB",
+         "hash us",
+         "MB/s",
+         "vbmeta us");
+  for (p = avb_stats; p < avb_stats + AVB_STATS_MAX_PARTITIONS; p++) {
+    if (p->name[0] == '\0') {
+      break;
+    }
+    printf("%-16s", p->name);
+    avb_stats_print_phase(p->bytes[AVB_STATS_READ],
+                          p->time_us[AVB_STATS_READ]);
+    avb_stats_print_phase(p->bytes[AVB_STATS_HASH],
+                          p->time_us[AVB_STATS_HASH]);
+    printf(" %9llu\n", p->time_us[AVB_STATS_VBMETA]);
+  }
+}
+
+static void avb_sha_bench_report(const char* name,
+                                 size_t len,
+                                 ulong us,
+                                 const uint8_t* digest) {
+  uint64_t div = us ? us : 1;
+
+  printf("%-16s %9lu us %4llu.%02llu MB/s  %02x%02x%02x%02x...\n",
+         name,
+         us,
+         (uint64_t)len / div,
+         (uint64_t)len % div * 100 / div,
+         digest[0],
+         digest[1],
+         digest[2],
+         digest[3]);
+}
+
+void avb_sha_bench(const uint8_t* buf, size_t len) {
+  AvbSHA256Ctx sha256_ctx;
+  AvbSHA512Ctx sha512_ctx;
+  uint8_t* digest;
+  ulong start;
+
+  start = timer_get_us();
+  avb_sha256_sw_init(&sha256_ctx);
+  avb_sha256_sw_update(&sha256_ctx, buf, len);
+  digest = avb_sha256_sw_final(&sha256_ctx);
+  avb_sha_bench_report("sha256 (C)", len, timer_get_us() - start, digest);
+
+#ifdef CONFIG_AML_HW_SHA2
+  start = timer_get_us();
+  avb_sha256_init(&sha256_ctx);
+  avb_sha256_update(&sha256_ctx, buf, len);
+  digest = avb_sha256_final(&sha256_ctx);
+  avb_sha_bench_report("sha256 (engine)", len, timer_get_us() - start, digest);
+#endif
+
+  start = timer_get_us();
+  avb_sha512_init(&sha512_ctx);
+  avb_sha512_update(&sha512_ctx, buf, len);
+  digest = avb_sha512_final(&sha512_ctx);
+  avb_sha_bench_report("sha512 (C)", len, timer_get_us() - start, digest);
+}
@@ -0,0 +1,244 @@
+/*
+ * LZ4 frame and legacy format decompressor
+ *
+ * Copyright (C) 2018 Amlogic, Inc. All rights reserved.
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <errno.h>
+#include <lz4.h>
+
+#define LZ4F_MAGIC		0x184D2204
+#define LZ4F_SKIP_MAGIC		0x184D2A50	/* low 4 bits are free */
+#define LZ4F_SKIP_MASK		0xFFFFFFF0
+#define LZ4_LEGACY_MAGIC	0x184C2102
+
+/* frame descriptor FLG byte */
+#define LZ4F_FLG_VERSION(f)	(((f) >> 6) & 0x3)
+#define LZ4F_FLG_BLK_CSUM	(1 << 4)
+#define LZ4F_FLG_CONTENT_SZ	(1 << 3)
+#define LZ4F_FLG_CONTENT_CSUM	(1 << 2)
+#define LZ4F_FLG_RESERVED	(1 << 1)
+#define LZ4F_FLG_DICT_ID	(1 << 0)
+
+#define LZ4F_BLK_UNCOMPRESSED	0x80000000
+
+#define LZ4_MIN_MATCH		4
+
+static inline u32 lz4_le32(const u8 *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((u32)p[3] << 24);
+}
+
+/* read an extended length: a run of 255 bytes ended by a smaller one */
+static inline int lz4_ext_len(const u8 **ip, const u8 *iend, size_t *len)
+{
+	u8 b;
+
+	do {
+		if (*ip >= iend)
+			return -EINVAL;
+		b = *(*ip)++;
+		*len += b;
+	} while (b == 255);
+
+	return 0;
+}
+
+/*
+ * Decompress one block [@src, @src + @srcn) to *@op. Matches may reach
+ * back to @obase, so blocks of a frame can depend on earlier ones.
+ */
+static int lz4_block(const u8 *src, size_t srcn, u8 **op, u8 *oend,
+		     const u8 *obase)
+{
+	const u8 *ip = src;
+	const u8 *iend = src + srcn;
+	u8 *out = *op;
+
+	while (ip < iend) {
+		u8 token = *ip++;
+		size_t len = token >> 4;
+		size_t offset;
+
+		if (len == 15 && lz4_ext_len(&ip, iend, &len))
+			return -EINVAL;
+		if (len > (size_t)(iend - ip))
+			return -EINVAL;
+		if (len > (size_t)(oend - out))
+			return -ENOBUFS;
+		memcpy(out, ip, len);
+		out += len;
+		ip += len;
+
+		/* the last sequence of a block has literals only */
+		if (ip == iend)
+			break;
+
+		if (iend - ip < 2)
+			return -EINVAL;
+		offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		if (!offset || offset > (size_t)(out - obase))
+			return -EINVAL;
+
+		len = token & 15;
+		if (len == 15 && lz4_ext_len(&ip, iend, &len))
+			return -EINVAL;
+		len += LZ4_MIN_MATCH;
+		if (len > (size_t)(oend - out))
+			return -ENOBUFS;
+
+		if (offset >= len) {
+			memcpy(out, out - offset, len);
+			out += len;
+		} else {
+			/* overlapping match repeats the last @offset bytes */
+			const u8 *match = out - offset;
+
+			while (len--)
+				*out++ = *match++;
+		}
+	}
+
+	*op = out;
+	return 0;
+}
+
+/* decompress one frame after its magic, return the bytes consumed */
+static int lz4_frame(const u8 *src, size_t srcn, u8 **op, u8 *oend,
+		     const u8 *obase, size_t *used)
+{
+	const u8 *ip = src;
+	const u8 *iend = src + srcn;
+	size_t hdr_len = 3;	/* FLG, BD, HC */
+	u8 flg;
+	int ret;
+
+	if (srcn < hdr_len)
+		return -EINVAL;
+	flg = ip[0];
+	if (LZ4F_FLG_VERSION(flg) != 1 || (flg & LZ4F_FLG_RESERVED))
+		return -EPROTONOSUPPORT;
+	/* no dictionary support */
+	if (flg & LZ4F_FLG_DICT_ID)
+		return -EPROTONOSUPPORT;
+	if (flg & LZ4F_FLG_CONTENT_SZ)
+		hdr_len += 8;
+	if (srcn < hdr_len)
+		return -EINVAL;
+	ip += hdr_len;
+
+	for (;;) {
+		u32 blk;
+		size_t blk_len;
+
+		if (iend - ip < 4)
+			return -EINVAL;
+		blk = lz4_le32(ip);
+		ip += 4;
+		if (!blk)
+			break;	/* end mark */
+
+		blk_len = blk & ~LZ4F_BLK_UNCOMPRESSED;
+		if (blk_len > (size_t)(iend - ip))
+			return -EINVAL;
+		if (blk & LZ4F_BLK_UNCOMPRESSED) {
+			if (blk_len > (size_t)(oend - *op))
+				return -ENOBUFS;
+			memcpy(*op, ip, blk_len);
+			*op += blk_len;
+		} else {
+			ret = lz4_block(ip, blk_len, op, oend, obase);
+			if (ret)
+				return ret;
+		}
+		ip += blk_len;
+		if (flg & LZ4F_FLG_BLK_CSUM)
+			ip += 4;
+	}
+	if (flg & LZ4F_FLG_CONTENT_CSUM)
+		ip += 4;
+	if (ip > iend)
+		return -EINVAL;
+
+	*used = ip - src;
+	return 0;
+}
+
+/* decompress legacy blocks after the magic, return the bytes consumed */
+static int lz4_legacy(const u8 *src, size_t srcn, u8 **op, u8 *oend,
+		      size_t *used)
+{
+	const u8 *ip = src;
+	const u8 *iend = src + srcn;
+	int ret;
+
+	while (iend - ip >= 4) {
+		u32 blk = lz4_le32(ip);
+
+		/* a new frame of any format follows */
+		if (blk == LZ4_LEGACY_MAGIC || blk == LZ4F_MAGIC ||
+		    (blk & LZ4F_SKIP_MASK) == LZ4F_SKIP_MAGIC)
+			break;
+		ip += 4;
+		/* kernel build appends the uncompressed size to the stream */
+		if (ip == iend)
+			break;
+		if (blk > (size_t)(iend - ip))
+			return -EINVAL;
+
+		/* legacy blocks are independent of each other */
+		ret = lz4_block(ip, blk, op, oend, *op);
+		if (ret)
+			return ret;
+		ip += blk;
+	}
+
+	*used = ip - src;
+	return 0;
+}
+
+int ulz4fn(const void *src, size_t srcn, void *dst, size_t *dstn)
+{
+	const u8 *ip = src;
+	const u8 *iend = ip + srcn;
+	u8 *op = dst;
+	u8 *oend = op + *dstn;
+	int frames = 0;
+	int ret = 0;
+
+	while (iend - ip >= 4) {
+		u32 magic = lz4_le32(ip);
+		size_t used = 0;
+
+		ip += 4;
+		if (magic == LZ4F_MAGIC) {
+			ret = lz4_frame(ip, iend - ip, &op, oend, dst, &used);
+		} else if (magic == LZ4_LEGACY_MAGIC) {
+			ret = lz4_legacy(ip, iend - ip, &op, oend, &used);
+		} else if ((magic & LZ4F_SKIP_MASK) == LZ4F_SKIP_MAGIC) {
+			if (iend - ip < 4)
+				return -EINVAL;
+			used = 4 + lz4_le32(ip);
+			if (used > (size_t)(iend - ip))
+				return -EINVAL;
+		} else if (frames) {
+			/* trailing data after the last frame */
+			break;
+		} else {
+			return -EPROTONOSUPPORT;
+		}
+		if (ret)
+			break;
+		ip += used;
+		frames++;
+	}
+
+	*dstn = op - (u8 *)dst;
+	if (ret)
+		return ret;
+	return frames ? 0 : -EPROTONOSUPPORT;
+}
@@ -195,31 +195,26 @@ static int eth_get_efuse_mac(struct eth_device *dev)
 #else
 #define MAC_MAX_LEN	17
 	int i = 0;
-	int err = 0, exist = 0;
-	ssize_t keysize = 0;
+	int err = 0;
 	const char* seedNum = "0x1234";
 	unsigned char buf[MAC_MAX_LEN+1] = {0};
+	struct key_unify_batch_t mac = {
+		.name = "mac",
+		.buf = buf,
+		.bufLen = MAC_MAX_LEN,
+	};
 
 	err = key_unify_init(seedNum, NULL);
 	if (err)
 		return err;
 
-	err = key_unify_query_exist("mac", &exist);
-	if (err || (!exist))
-		return -EEXIST;
+	if (key_unify_read_batch(&mac, 1))
+		return mac.err == -ENOENT ? -EEXIST : mac.err;
 
-	err = key_unify_query_size("mac", &keysize);
-	if (err)
-		return err;
-
-	if (keysize != MAC_MAX_LEN) {
+	if (mac.size != MAC_MAX_LEN) {
 		return -EINVAL;
 	}
 
-	err = key_unify_read("mac", buf, keysize);
-	if (err)
-		return err;
-
 	for (i=0; i<6; i++) {
 		buf[i*3 + 2] = '\0';
 		dev->enetaddr[i] = simple_strtoul((char *)&buf[i*3], NULL, 16);